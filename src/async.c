@@ -2,7 +2,7 @@
 static void
 on_async_callback(uv_async_t *async, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(async->loop);
     Async *self;
     PyObject *result;
 
@@ -14,7 +14,7 @@ on_async_callback(uv_async_t *async, int status)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, NULL);
+    result = pyuv_call1(self->callback, (PyObject *)self);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -72,12 +72,7 @@ Async_tp_init(Async *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_async = PyMem_Malloc(sizeof(uv_async_t));
-    if (!uv_async) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_async = &self->async_h;
 
     r = uv_async_init(UV_HANDLE_LOOP(self), uv_async, on_async_callback);
     if (r != 0) {
@@ -0,0 +1,518 @@
+
+/*
+ * Deferred calls scheduled with Loop.call_later / Loop.call_at. All of them live in
+ * a binary heap (ordered by expiration time and insertion order) which is driven by
+ * a single timer, so no handle needs to be allocated for each call.
+ */
+
+#define CALL_QUEUE_ITEM(q, i) ((ScheduledCall *)(q)->heap[(i)])
+
+/* calls are driven by a libuv timer, which takes a signed 64 bit timeout */
+#define CALL_QUEUE_MAX_TIME ((uint64_t)INT64_MAX)
+
+
+static INLINE int
+call_queue_less(ScheduledCall *a, ScheduledCall *b)
+{
+    return a->when < b->when || (a->when == b->when && a->seq < b->seq);
+}
+
+
+static INLINE void
+call_queue_set(call_queue_t *queue, Py_ssize_t index, ScheduledCall *item)
+{
+    queue->heap[index] = (PyObject *)item;
+    item->index = index;
+}
+
+
+static void
+call_queue_sift_up(call_queue_t *queue, Py_ssize_t index)
+{
+    Py_ssize_t parent;
+    ScheduledCall *item = CALL_QUEUE_ITEM(queue, index);
+
+    while (index > 0) {
+        parent = (index - 1) / 2;
+        if (!call_queue_less(item, CALL_QUEUE_ITEM(queue, parent))) {
+            break;
+        }
+        call_queue_set(queue, index, CALL_QUEUE_ITEM(queue, parent));
+        index = parent;
+    }
+    call_queue_set(queue, index, item);
+}
+
+
+static void
+call_queue_sift_down(call_queue_t *queue, Py_ssize_t index)
+{
+    Py_ssize_t child;
+    ScheduledCall *item = CALL_QUEUE_ITEM(queue, index);
+
+    for (;;) {
+        child = 2 * index + 1;
+        if (child >= queue->len) {
+            break;
+        }
+        if (child + 1 < queue->len && call_queue_less(CALL_QUEUE_ITEM(queue, child + 1), CALL_QUEUE_ITEM(queue, child))) {
+            child++;
+        }
+        if (!call_queue_less(CALL_QUEUE_ITEM(queue, child), item)) {
+            break;
+        }
+        call_queue_set(queue, index, CALL_QUEUE_ITEM(queue, child));
+        index = child;
+    }
+    call_queue_set(queue, index, item);
+}
+
+
+/* add an item to the heap, the heap steals the reference */
+static int
+call_queue_push(call_queue_t *queue, ScheduledCall *item)
+{
+    Py_ssize_t size;
+    PyObject **heap;
+
+    if (queue->len == queue->size) {
+        size = queue->size ? queue->size * 2 : 64;
+        heap = PyMem_Realloc(queue->heap, sizeof(PyObject *) * size);
+        if (!heap) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        queue->heap = heap;
+        queue->size = size;
+    }
+
+    item->seq = queue->seq++;
+    call_queue_set(queue, queue->len++, item);
+    call_queue_sift_up(queue, item->index);
+    return 0;
+}
+
+
+/* remove an item from the heap, the caller gets the reference */
+static void
+call_queue_remove(call_queue_t *queue, ScheduledCall *item)
+{
+    Py_ssize_t index = item->index;
+    ScheduledCall *last;
+
+    ASSERT(index >= 0 && index < queue->len);
+
+    item->index = -1;
+    last = CALL_QUEUE_ITEM(queue, --queue->len);
+    if (last != item) {
+        call_queue_set(queue, index, last);
+        call_queue_sift_down(queue, index);
+        call_queue_sift_up(queue, last->index);
+    }
+}
+
+
+static void on_call_queue_timer(uv_timer_t *handle, int status);
+
+
+/*
+ * arm the timer for the earliest call, stop it if there is nothing left. The timer
+ * fires up to 'slack' milliseconds late, so that all calls due in that window run
+ * in a single batch.
+ */
+static void
+call_queue_arm(call_queue_t *queue)
+{
+    uint64_t now, when;
+
+    if (queue->len == 0) {
+        uv_timer_stop(&queue->timer_handle);
+        return;
+    }
+
+    when = CALL_QUEUE_ITEM(queue, 0)->when + queue->loop->call_slack;
+    if (uv_is_active((uv_handle_t *)&queue->timer_handle) && queue->armed == when) {
+        return;
+    }
+
+    now = (uint64_t)uv_now(queue->timer_handle.loop);
+    queue->armed = when;
+    uv_timer_start(&queue->timer_handle, on_call_queue_timer, (when > now) ? when - now : 0, 0);
+}
+
+
+static void
+on_call_queue_timer(uv_timer_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    uint64_t now;
+    Py_ssize_t i;
+    call_queue_t *queue;
+    ScheduledCall *item;
+    Loop *loop;
+    PyObject *batch, *result;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    queue = (call_queue_t *)handle;
+    loop = queue->loop;
+    Py_INCREF(loop);
+
+    /* take all due calls first, calls scheduled from the callbacks will run in the next round */
+    now = (uint64_t)uv_now(handle->loop);
+    batch = PyList_New(0);
+    if (!batch) {
+        handle_uncaught_exception(loop);
+        goto done;
+    }
+    while (queue->len > 0 && CALL_QUEUE_ITEM(queue, 0)->when <= now) {
+        item = CALL_QUEUE_ITEM(queue, 0);
+        call_queue_remove(queue, item);
+        if (PyList_Append(batch, (PyObject *)item) != 0) {
+            handle_uncaught_exception(loop);
+        }
+        Py_DECREF(item);
+    }
+
+    for (i = 0; i < PyList_GET_SIZE(batch); i++) {
+        item = (ScheduledCall *)PyList_GET_ITEM(batch, i);
+        /* it could have been cancelled by a previous call in this batch */
+        if (item->cancelled) {
+            continue;
+        }
+        result = PyObject_Call(item->callback, item->args, NULL);
+        if (result == NULL) {
+            handle_uncaught_exception(loop);
+        }
+        Py_XDECREF(result);
+    }
+    Py_DECREF(batch);
+
+done:
+    call_queue_arm(queue);
+    Py_DECREF(loop);
+    PyGILState_Release(gstate);
+}
+
+
+static call_queue_t *
+call_queue_new(Loop *loop)
+{
+    int r;
+    call_queue_t *queue;
+
+    queue = (call_queue_t *)PyMem_Malloc(sizeof(call_queue_t));
+    if (!queue) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    r = uv_timer_init(loop->uv_loop, &queue->timer_handle);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(loop->uv_loop, PyExc_TimerError);
+        PyMem_Free(queue);
+        return NULL;
+    }
+    /* internal handle, not visible to Loop.walk */
+    queue->timer_handle.data = NULL;
+
+    queue->loop = loop;
+    queue->heap = NULL;
+    queue->len = 0;
+    queue->size = 0;
+    queue->seq = 0;
+    queue->armed = 0;
+
+    return queue;
+}
+
+
+static int
+call_queue_traverse(call_queue_t *queue, visitproc visit, void *arg)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < queue->len; i++) {
+        Py_VISIT(queue->heap[i]);
+    }
+    return 0;
+}
+
+
+/* drop all pending calls, the timer finds the queue empty and stops if it fires */
+static void
+call_queue_clear(call_queue_t *queue)
+{
+    Py_ssize_t i, len;
+    PyObject **heap;
+
+    /* detach the heap first, dropping a call can run arbitrary code */
+    heap = queue->heap;
+    len = queue->len;
+    queue->heap = NULL;
+    queue->len = 0;
+    queue->size = 0;
+
+    for (i = 0; i < len; i++) {
+        ((ScheduledCall *)heap[i])->index = -1;
+    }
+    for (i = 0; i < len; i++) {
+        Py_DECREF(heap[i]);
+    }
+    PyMem_Free(heap);
+}
+
+
+/* free the queue memory after the loop it was running on has been deleted */
+static void
+call_queue_destroy(call_queue_t *queue)
+{
+    call_queue_clear(queue);
+    PyMem_Free(queue);
+}
+
+
+/* schedule a call at the given loop time (in milliseconds), args is (callback, arg1, ...) */
+static PyObject *
+pyuv_loop_schedule_call(Loop *self, uint64_t when, PyObject *args, Py_ssize_t offset)
+{
+    ScheduledCall *item;
+    PyObject *callback, *cb_args;
+
+    callback = PyTuple_GET_ITEM(args, offset);
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (!self->call_queue) {
+        self->call_queue = call_queue_new(self);
+        if (!self->call_queue) {
+            return NULL;
+        }
+    }
+
+    cb_args = PyTuple_GetSlice(args, offset + 1, PyTuple_GET_SIZE(args));
+    if (!cb_args) {
+        return NULL;
+    }
+
+    item = PyObject_GC_New(ScheduledCall, &ScheduledCallType);
+    if (!item) {
+        Py_DECREF(cb_args);
+        return NULL;
+    }
+    Py_INCREF(self);
+    item->loop = self;
+    Py_INCREF(callback);
+    item->callback = callback;
+    item->args = cb_args;
+    item->when = when;
+    item->index = -1;
+    item->cancelled = False;
+    PyObject_GC_Track(item);
+
+    /* the heap keeps a reference while the call is pending */
+    Py_INCREF(item);
+    if (call_queue_push(self->call_queue, item) != 0) {
+        Py_DECREF(item);
+        Py_DECREF(item);
+        return NULL;
+    }
+    call_queue_arm(self->call_queue);
+
+    return (PyObject *)item;
+}
+
+
+static PyObject *
+Loop_func_call_later(Loop *self, PyObject *args)
+{
+    double delay;
+    uint64_t now;
+
+    if (PyTuple_GET_SIZE(args) < 2) {
+        PyErr_SetString(PyExc_TypeError, "call_later requires at least 2 arguments");
+        return NULL;
+    }
+
+    delay = PyFloat_AsDouble(PyTuple_GET_ITEM(args, 0));
+    if (delay == -1.0 && PyErr_Occurred()) {
+        return NULL;
+    }
+
+    if (delay < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    now = (uint64_t)uv_now(self->uv_loop);
+    if (delay * 1000 >= (double)(CALL_QUEUE_MAX_TIME - now)) {
+        PyErr_SetString(PyExc_OverflowError, "delay is too large");
+        return NULL;
+    }
+
+    return pyuv_loop_schedule_call(self, now + (uint64_t)(delay * 1000), args, 1);
+}
+
+
+static PyObject *
+Loop_func_call_at(Loop *self, PyObject *args)
+{
+    double when;
+    uint64_t now;
+
+    if (PyTuple_GET_SIZE(args) < 2) {
+        PyErr_SetString(PyExc_TypeError, "call_at requires at least 2 arguments");
+        return NULL;
+    }
+
+    when = PyFloat_AsDouble(PyTuple_GET_ITEM(args, 0));
+    if (when == -1.0 && PyErr_Occurred()) {
+        return NULL;
+    }
+
+    now = (uint64_t)uv_now(self->uv_loop);
+    if (when * 1000 <= (double)now) {
+        return pyuv_loop_schedule_call(self, now, args, 1);
+    }
+    if (when * 1000 >= (double)CALL_QUEUE_MAX_TIME) {
+        PyErr_SetString(PyExc_OverflowError, "time is too large");
+        return NULL;
+    }
+    return pyuv_loop_schedule_call(self, (uint64_t)(when * 1000), args, 1);
+}
+
+
+static PyObject *
+ScheduledCall_func_cancel(ScheduledCall *self)
+{
+    call_queue_t *queue;
+
+    if (self->cancelled) {
+        Py_RETURN_NONE;
+    }
+    self->cancelled = True;
+
+    if (self->index >= 0) {
+        queue = self->loop->call_queue;
+        call_queue_remove(queue, self);
+        call_queue_arm(queue);
+        /* reference was held by the heap */
+        Py_DECREF(self);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+ScheduledCall_cancelled_get(ScheduledCall *self, void *closure)
+{
+    UNUSED_ARG(closure);
+
+    return PyBool_FromLong((long)self->cancelled);
+}
+
+
+static PyObject *
+ScheduledCall_when_get(ScheduledCall *self, void *closure)
+{
+    UNUSED_ARG(closure);
+
+    return PyFloat_FromDouble(self->when / 1000.0);
+}
+
+
+static int
+ScheduledCall_tp_traverse(ScheduledCall *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->loop);
+    Py_VISIT(self->callback);
+    Py_VISIT(self->args);
+    return 0;
+}
+
+
+static int
+ScheduledCall_tp_clear(ScheduledCall *self)
+{
+    Py_CLEAR(self->loop);
+    Py_CLEAR(self->callback);
+    Py_CLEAR(self->args);
+    return 0;
+}
+
+
+static void
+ScheduledCall_tp_dealloc(ScheduledCall *self)
+{
+    PyObject_GC_UnTrack(self);
+    ScheduledCall_tp_clear(self);
+    PyObject_GC_Del(self);
+}
+
+
+static PyMethodDef
+ScheduledCall_tp_methods[] = {
+    { "cancel", (PyCFunction)ScheduledCall_func_cancel, METH_NOARGS, "Cancel the call, if it didn't happen yet." },
+    { NULL }
+};
+
+
+static PyMemberDef ScheduledCall_tp_members[] = {
+    {"callback", T_OBJECT_EX, offsetof(ScheduledCall, callback), READONLY, "Function to be called."},
+    {"args", T_OBJECT_EX, offsetof(ScheduledCall, args), READONLY, "Arguments the function is called with."},
+    {NULL}
+};
+
+
+static PyGetSetDef ScheduledCall_tp_getsets[] = {
+    {"cancelled", (getter)ScheduledCall_cancelled_get, NULL, "Indicates if the call was cancelled.", NULL},
+    {"when", (getter)ScheduledCall_when_get, NULL, "Loop time the call is scheduled for, in seconds.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject ScheduledCallType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.ScheduledCall",                                           /*tp_name*/
+    sizeof(ScheduledCall),                                          /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)ScheduledCall_tp_dealloc,                           /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)ScheduledCall_tp_traverse,                        /*tp_traverse*/
+    (inquiry)ScheduledCall_tp_clear,                                /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    ScheduledCall_tp_methods,                                       /*tp_methods*/
+    ScheduledCall_tp_members,                                       /*tp_members*/
+    ScheduledCall_tp_getsets,                                       /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    0,                                                              /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    0,                                                              /*tp_new*/
+};
+
@@ -0,0 +1,329 @@
+
+/*
+ * Calls scheduled with Loop.call_soon. (callback, args) pairs are kept in a ring buffer
+ * which is drained by a single idle handle, once per loop iteration, so no handle needs
+ * to be allocated for each call and all of them run with a single GIL acquisition.
+ */
+
+#define READY_QUEUE_SLOT(q, i) (&(q)->items[(((q)->head + (i)) & ((q)->size - 1)) * 2])
+
+
+/* append a call to the queue, the queue steals both references */
+static int
+ready_queue_push(ready_queue_t *queue, PyObject *callback, PyObject *args)
+{
+    Py_ssize_t i, size;
+    PyObject **items, **slot;
+
+    if (queue->len == queue->size) {
+        size = queue->size ? queue->size * 2 : 64;
+        items = PyMem_Malloc(sizeof(PyObject *) * 2 * size);
+        if (!items) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        /* unwrap the ring, so that the oldest call lands at the beginning */
+        for (i = 0; i < queue->len; i++) {
+            slot = READY_QUEUE_SLOT(queue, i);
+            items[i * 2] = slot[0];
+            items[i * 2 + 1] = slot[1];
+        }
+        PyMem_Free(queue->items);
+        queue->items = items;
+        queue->size = size;
+        queue->head = 0;
+    }
+
+    slot = READY_QUEUE_SLOT(queue, queue->len);
+    slot[0] = callback;
+    slot[1] = args;
+    queue->len++;
+    return 0;
+}
+
+
+static void
+on_ready_queue_idle(uv_idle_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    Py_ssize_t i, count;
+    ready_queue_t *queue;
+    Loop *loop;
+    PyObject *callback, *args, *result, **slot;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    queue = (ready_queue_t *)handle;
+    loop = queue->loop;
+    Py_INCREF(loop);
+
+    /* calls scheduled from the callbacks will run in the next iteration */
+    count = queue->len;
+    if (loop->call_soon_limit > 0 && count > loop->call_soon_limit) {
+        count = loop->call_soon_limit;
+    }
+
+    for (i = 0; i < count; i++) {
+        slot = READY_QUEUE_SLOT(queue, 0);
+        callback = slot[0];
+        args = slot[1];
+        queue->head = (queue->head + 1) & (queue->size - 1);
+        queue->len--;
+
+        result = PyObject_Call(callback, args, NULL);
+        if (result == NULL) {
+            handle_uncaught_exception(loop);
+        }
+        Py_XDECREF(result);
+        Py_DECREF(callback);
+        Py_DECREF(args);
+    }
+
+    if (queue->len == 0) {
+        uv_idle_stop(&queue->idle_handle);
+    }
+
+    Py_DECREF(loop);
+    PyGILState_Release(gstate);
+}
+
+
+static ready_queue_t *
+ready_queue_new(Loop *loop)
+{
+    int r;
+    ready_queue_t *queue;
+
+    queue = (ready_queue_t *)PyMem_Malloc(sizeof(ready_queue_t));
+    if (!queue) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    r = uv_idle_init(loop->uv_loop, &queue->idle_handle);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(loop->uv_loop, PyExc_IdleError);
+        PyMem_Free(queue);
+        return NULL;
+    }
+    /* internal handle, not visible to Loop.walk */
+    queue->idle_handle.data = NULL;
+
+    queue->loop = loop;
+    queue->items = NULL;
+    queue->head = 0;
+    queue->len = 0;
+    queue->size = 0;
+
+    return queue;
+}
+
+
+static int
+ready_queue_traverse(ready_queue_t *queue, visitproc visit, void *arg)
+{
+    Py_ssize_t i;
+    PyObject **slot;
+
+    for (i = 0; i < queue->len; i++) {
+        slot = READY_QUEUE_SLOT(queue, i);
+        Py_VISIT(slot[0]);
+        Py_VISIT(slot[1]);
+    }
+    return 0;
+}
+
+
+/* drop all pending calls */
+static void
+ready_queue_clear(ready_queue_t *queue)
+{
+    PyObject **slot;
+
+    while (queue->len > 0) {
+        slot = READY_QUEUE_SLOT(queue, 0);
+        queue->head = (queue->head + 1) & (queue->size - 1);
+        queue->len--;
+        Py_DECREF(slot[0]);
+        Py_DECREF(slot[1]);
+    }
+}
+
+
+/* free the queue memory after the loop it was running on has been deleted */
+static void
+ready_queue_destroy(ready_queue_t *queue)
+{
+    ready_queue_clear(queue);
+    PyMem_Free(queue->items);
+    PyMem_Free(queue);
+}
+
+
+static PyObject *
+Loop_func_call_soon(Loop *self, PyObject *args)
+{
+    PyObject *callback, *cb_args;
+
+    if (PyTuple_GET_SIZE(args) < 1) {
+        PyErr_SetString(PyExc_TypeError, "call_soon requires at least 1 argument");
+        return NULL;
+    }
+
+    callback = PyTuple_GET_ITEM(args, 0);
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (!self->ready_queue) {
+        self->ready_queue = ready_queue_new(self);
+        if (!self->ready_queue) {
+            return NULL;
+        }
+    }
+
+    cb_args = PyTuple_GetSlice(args, 1, PyTuple_GET_SIZE(args));
+    if (!cb_args) {
+        return NULL;
+    }
+
+    Py_INCREF(callback);
+    if (ready_queue_push(self->ready_queue, callback, cb_args) != 0) {
+        Py_DECREF(callback);
+        Py_DECREF(cb_args);
+        return NULL;
+    }
+
+    /* the active idle handle keeps the loop alive and prevents it from blocking for I/O */
+    if (self->ready_queue->len == 1) {
+        uv_idle_start(&self->ready_queue->idle_handle, on_ready_queue_idle);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+
+/*
+ * Calls scheduled from other threads with Loop.call_soon_threadsafe. Calls are pushed on a
+ * lock-free stack and the loop is only woken up when the stack was empty, the loop takes
+ * the whole stack at once and runs the calls in the order they were scheduled.
+ */
+
+static void
+on_threadsafe_async(uv_async_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    Loop *loop;
+    threadsafe_call_t *calls, *call, *next, *reversed;
+    PyObject *result;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    loop = container_of(handle, Loop, threadsafe_async);
+    Py_INCREF(loop);
+
+    calls = (threadsafe_call_t *)PYUV_ATOMIC_XCHG_PTR(&loop->threadsafe_calls, NULL);
+
+    /* the stack has the newest call first, reverse it */
+    reversed = NULL;
+    for (call = calls; call; call = next) {
+        next = call->next;
+        call->next = reversed;
+        reversed = call;
+    }
+
+    for (call = reversed; call; call = next) {
+        next = call->next;
+        result = PyObject_Call(call->callback, call->args, NULL);
+        if (result == NULL) {
+            handle_uncaught_exception(loop);
+        }
+        Py_XDECREF(result);
+        Py_DECREF(call->callback);
+        Py_DECREF(call->args);
+        PyMem_Free(call);
+    }
+
+    Py_DECREF(loop);
+    PyGILState_Release(gstate);
+}
+
+
+static int
+threadsafe_calls_traverse(Loop *loop, visitproc visit, void *arg)
+{
+    threadsafe_call_t *call;
+
+    for (call = loop->threadsafe_calls; call; call = call->next) {
+        Py_VISIT(call->callback);
+        Py_VISIT(call->args);
+    }
+    return 0;
+}
+
+
+/* drop all pending calls */
+static void
+threadsafe_calls_clear(Loop *loop)
+{
+    threadsafe_call_t *call, *next;
+
+    call = (threadsafe_call_t *)PYUV_ATOMIC_XCHG_PTR(&loop->threadsafe_calls, NULL);
+    while (call) {
+        next = call->next;
+        Py_DECREF(call->callback);
+        Py_DECREF(call->args);
+        PyMem_Free(call);
+        call = next;
+    }
+}
+
+
+static PyObject *
+Loop_func_call_soon_threadsafe(Loop *self, PyObject *args)
+{
+    PyObject *callback, *cb_args;
+    threadsafe_call_t *call, *head;
+
+    if (PyTuple_GET_SIZE(args) < 1) {
+        PyErr_SetString(PyExc_TypeError, "call_soon_threadsafe requires at least 1 argument");
+        return NULL;
+    }
+
+    callback = PyTuple_GET_ITEM(args, 0);
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    cb_args = PyTuple_GetSlice(args, 1, PyTuple_GET_SIZE(args));
+    if (!cb_args) {
+        return NULL;
+    }
+
+    call = PyMem_Malloc(sizeof(threadsafe_call_t));
+    if (!call) {
+        Py_DECREF(cb_args);
+        return PyErr_NoMemory();
+    }
+    Py_INCREF(callback);
+    call->callback = callback;
+    call->args = cb_args;
+
+    do {
+        head = self->threadsafe_calls;
+        call->next = head;
+    } while (!PYUV_ATOMIC_CAS_PTR(&self->threadsafe_calls, head, call));
+
+    /* the loop only needs to be woken up for the first pending call */
+    if (head == NULL) {
+        uv_async_send(&self->threadsafe_async);
+    }
+
+    Py_RETURN_NONE;
+}
+
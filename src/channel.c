@@ -0,0 +1,304 @@
+
+/*
+ * Channel: Async handle which carries objects. Senders push items on a lock-free
+ * stack and only wake up the loop when the stack was empty, the loop takes the whole
+ * stack at once and hands the items to the callback, in the order they were sent.
+ */
+
+static void
+on_channel_async(uv_async_t *async, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(async->loop);
+    Py_ssize_t i, count;
+    Channel *self;
+    channel_item_t *items, *item, *next, *reversed;
+    PyObject *result, *objs;
+
+    ASSERT(async);
+    ASSERT(status == 0);
+
+    self = (Channel *)async->data;
+    ASSERT(self);
+    /* Object could go out of scope in the callback, increase refcount to avoid it */
+    Py_INCREF(self);
+
+    items = (channel_item_t *)PYUV_ATOMIC_XCHG_PTR(&self->head, NULL);
+
+    /* the stack has the newest item first, reverse it */
+    count = 0;
+    reversed = NULL;
+    for (item = items; item; item = next) {
+        next = item->next;
+        item->next = reversed;
+        reversed = item;
+        count++;
+    }
+
+    if (count == 0) {
+        goto done;
+    }
+
+    objs = PyList_New(count);
+    if (!objs) {
+        for (item = reversed; item; item = next) {
+            next = item->next;
+            Py_DECREF(item->obj);
+            PyMem_Free(item);
+        }
+        handle_uncaught_exception(((Handle *)self)->loop);
+        goto done;
+    }
+
+    /* the list steals the references */
+    for (i = 0, item = reversed; item; i++, item = next) {
+        next = item->next;
+        PyList_SET_ITEM(objs, i, item->obj);
+        PyMem_Free(item);
+    }
+
+    result = pyuv_call2(self->callback, (PyObject *)self, objs);
+    if (result == NULL) {
+        handle_uncaught_exception(((Handle *)self)->loop);
+    }
+    Py_XDECREF(result);
+    Py_DECREF(objs);
+
+done:
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+/* push an item, returns True if the channel was empty and the loop needs to be woken up */
+static INLINE Bool
+channel_push(Channel *self, channel_item_t *item)
+{
+    channel_item_t *head;
+
+    do {
+        head = self->head;
+        item->next = head;
+    } while (!PYUV_ATOMIC_CAS_PTR(&self->head, head, item));
+
+    return head == NULL;
+}
+
+
+static PyObject *
+Channel_func_send(Channel *self, PyObject *obj)
+{
+    int r;
+    channel_item_t *item;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    item = PyMem_Malloc(sizeof(channel_item_t));
+    if (!item) {
+        return PyErr_NoMemory();
+    }
+    Py_INCREF(obj);
+    item->obj = obj;
+
+    if (channel_push(self, item)) {
+        r = uv_async_send((uv_async_t *)UV_HANDLE(self));
+        if (r != 0) {
+            RAISE_UV_EXCEPTION(UV_LOOP((Handle *)self), PyExc_ChannelError);
+            return NULL;
+        }
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+/* drop all pending items */
+static void
+channel_clear(Channel *self)
+{
+    channel_item_t *item, *next;
+
+    item = (channel_item_t *)PYUV_ATOMIC_XCHG_PTR(&self->head, NULL);
+    while (item) {
+        next = item->next;
+        Py_DECREF(item->obj);
+        PyMem_Free(item);
+        item = next;
+    }
+}
+
+
+static PyObject *
+Channel_func_close(Channel *self, PyObject *args)
+{
+    PyObject *result;
+
+    result = Handle_func_close((Handle *)self, args);
+    if (result) {
+        /* items which were not delivered yet are lost */
+        channel_clear(self);
+    }
+    return result;
+}
+
+
+static PyObject *
+Channel_pending_get(Channel *self, void *closure)
+{
+    Py_ssize_t count;
+    channel_item_t *item;
+
+    UNUSED_ARG(closure);
+
+    /* items are only pushed while holding the GIL, so the stack can be walked safely */
+    count = 0;
+    for (item = self->head; item; item = item->next) {
+        count++;
+    }
+    return PyInt_FromSsize_t(count);
+}
+
+
+static int
+Channel_tp_init(Channel *self, PyObject *args, PyObject *kwargs)
+{
+    int r;
+    uv_async_t *uv_async = NULL;
+    Loop *loop;
+    PyObject *callback;
+    PyObject *tmp = NULL;
+
+    UNUSED_ARG(kwargs);
+
+    if (UV_HANDLE(self)) {
+        PyErr_SetString(PyExc_ChannelError, "Object already initialized");
+        return -1;
+    }
+
+    if (!PyArg_ParseTuple(args, "O!O:__init__", &LoopType, &loop, &callback)) {
+        return -1;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return -1;
+    }
+
+    tmp = (PyObject *)((Handle *)self)->loop;
+    Py_INCREF(loop);
+    ((Handle *)self)->loop = loop;
+    Py_XDECREF(tmp);
+
+    uv_async = &self->async_h;
+
+    r = uv_async_init(UV_HANDLE_LOOP(self), uv_async, on_channel_async);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_ChannelError);
+        Py_DECREF(loop);
+        return -1;
+    }
+
+    tmp = self->callback;
+    Py_INCREF(callback);
+    self->callback = callback;
+    Py_XDECREF(tmp);
+
+    self->head = NULL;
+
+    uv_async->data = (void *)self;
+    UV_HANDLE(self) = (uv_handle_t *)uv_async;
+
+    return 0;
+}
+
+
+static PyObject *
+Channel_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    Channel *self = (Channel *)HandleType.tp_new(type, args, kwargs);
+    if (!self) {
+        return NULL;
+    }
+    self->head = NULL;
+    return (PyObject *)self;
+}
+
+
+static int
+Channel_tp_traverse(Channel *self, visitproc visit, void *arg)
+{
+    channel_item_t *item;
+
+    Py_VISIT(self->callback);
+    for (item = self->head; item; item = item->next) {
+        Py_VISIT(item->obj);
+    }
+    HandleType.tp_traverse((PyObject *)self, visit, arg);
+    return 0;
+}
+
+
+static int
+Channel_tp_clear(Channel *self)
+{
+    Py_CLEAR(self->callback);
+    channel_clear(self);
+    HandleType.tp_clear((PyObject *)self);
+    return 0;
+}
+
+
+static PyMethodDef
+Channel_tp_methods[] = {
+    { "send", (PyCFunction)Channel_func_send, METH_O, "Send an object to the loop thread." },
+    { "close", (PyCFunction)Channel_func_close, METH_VARARGS, "Close the handle, dropping the items which were not delivered." },
+    { NULL }
+};
+
+
+static PyGetSetDef Channel_tp_getsets[] = {
+    {"pending", (getter)Channel_pending_get, NULL, "Number of items waiting to be delivered.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject ChannelType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.Channel",                                                 /*tp_name*/
+    sizeof(Channel),                                                /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    0,                                                              /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)Channel_tp_traverse,                              /*tp_traverse*/
+    (inquiry)Channel_tp_clear,                                      /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    Channel_tp_methods,                                             /*tp_methods*/
+    0,                                                              /*tp_members*/
+    Channel_tp_getsets,                                             /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    (initproc)Channel_tp_init,                                      /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    Channel_tp_new,                                                 /*tp_new*/
+};
+
@@ -2,7 +2,7 @@
 static void
 on_check_callback(uv_check_t *handle, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     Check *self;
     PyObject *result;
 
@@ -14,7 +14,7 @@ on_check_callback(uv_check_t *handle, int status)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, NULL);
+    result = pyuv_call1(self->callback, (PyObject *)self);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -103,12 +103,7 @@ Check_tp_init(Check *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_check = PyMem_Malloc(sizeof(uv_check_t));
-    if (!uv_check) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_check = &self->check_h;
 
     r = uv_check_init(UV_HANDLE_LOOP(self), uv_check);
     if (r != 0) {
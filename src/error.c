@@ -33,6 +33,7 @@ init_error(void)
     PyExc_SignalError = PyErr_NewException("pyuv.error.SignalError", PyExc_HandleError, NULL);
     PyExc_StreamError = PyErr_NewException("pyuv.error.StreamError", PyExc_HandleError, NULL);
     PyExc_TCPError = PyErr_NewException("pyuv.error.TCPError", PyExc_StreamError, NULL);
+    PyExc_TCPPoolError = PyErr_NewException("pyuv.error.TCPPoolError", PyExc_UVError, NULL);
     PyExc_PipeError = PyErr_NewException("pyuv.error.PipeError", PyExc_StreamError, NULL);
     PyExc_TTYError = PyErr_NewException("pyuv.error.TTYError", PyExc_StreamError, NULL);
     PyExc_UDPError = PyErr_NewException("pyuv.error.UDPError", PyExc_HandleError, NULL);
@@ -43,6 +44,8 @@ init_error(void)
     PyExc_FSPollError = PyErr_NewException("pyuv.error.FSPollError", PyExc_HandleError, NULL);
     PyExc_ProcessError = PyErr_NewException("pyuv.error.ProcessError", PyExc_HandleError, NULL);
     PyExc_SignalCheckerError = PyErr_NewException("pyuv.error.SignalCheckerError", PyExc_UVError, NULL);
+    PyExc_ShmChannelError = PyErr_NewException("pyuv.error.ShmChannelError", PyExc_HandleError, NULL);
+    PyExc_ChannelError = PyErr_NewException("pyuv.error.ChannelError", PyExc_HandleError, NULL);
 
     PyUVModule_AddType(module, "UVError", (PyTypeObject *)PyExc_UVError);
     PyUVModule_AddType(module, "HandleError", (PyTypeObject *)PyExc_HandleError);
@@ -54,6 +57,7 @@ init_error(void)
     PyUVModule_AddType(module, "SignalError", (PyTypeObject *)PyExc_SignalError);
     PyUVModule_AddType(module, "StreamError", (PyTypeObject *)PyExc_StreamError);
     PyUVModule_AddType(module, "TCPError", (PyTypeObject *)PyExc_TCPError);
+    PyUVModule_AddType(module, "TCPPoolError", (PyTypeObject *)PyExc_TCPPoolError);
     PyUVModule_AddType(module, "PipeError", (PyTypeObject *)PyExc_PipeError);
     PyUVModule_AddType(module, "TTYError", (PyTypeObject *)PyExc_TTYError);
     PyUVModule_AddType(module, "UDPError", (PyTypeObject *)PyExc_UDPError);
@@ -64,6 +68,8 @@ init_error(void)
     PyUVModule_AddType(module, "FSPollError", (PyTypeObject *)PyExc_FSPollError);
     PyUVModule_AddType(module, "ProcessError", (PyTypeObject *)PyExc_ProcessError);
     PyUVModule_AddType(module, "SignalCheckerError", (PyTypeObject *)PyExc_SignalCheckerError);
+    PyUVModule_AddType(module, "ShmChannelError", (PyTypeObject *)PyExc_ShmChannelError);
+    PyUVModule_AddType(module, "ChannelError", (PyTypeObject *)PyExc_ChannelError);
 
     return module;
 }
@@ -160,15 +160,18 @@ process_stat(uv_fs_t* req, PyObject **path, PyObject **stat_data, PyObject **err
 
 static void
 stat_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *stat_data, *path;
+    uint64_t start;
 
     process_stat(req, &path, &stat_data, &errorno);
     callback = (PyObject *)req->data;
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, stat_data, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call4(callback, (PyObject *)loop, path, stat_data, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -188,9 +191,10 @@ stat_cb(uv_fs_t* req) {
 
 static void
 unlink_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_UNLINK);
@@ -212,7 +216,9 @@ unlink_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -231,9 +237,10 @@ unlink_cb(uv_fs_t* req) {
 
 static void
 mkdir_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_MKDIR);
@@ -255,7 +262,9 @@ mkdir_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -274,9 +283,10 @@ mkdir_cb(uv_fs_t* req) {
 
 static void
 rmdir_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_RMDIR);
@@ -298,7 +308,9 @@ rmdir_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -317,9 +329,10 @@ rmdir_cb(uv_fs_t* req) {
 
 static void
 rename_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_RENAME);
@@ -341,7 +354,9 @@ rename_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -360,9 +375,10 @@ rename_cb(uv_fs_t* req) {
 
 static void
 chmod_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_CHMOD || req->fs_type == UV_FS_FCHMOD);
@@ -384,7 +400,9 @@ chmod_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -403,9 +421,10 @@ chmod_cb(uv_fs_t* req) {
 
 static void
 link_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_LINK);
@@ -427,7 +446,9 @@ link_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -446,9 +467,10 @@ link_cb(uv_fs_t* req) {
 
 static void
 symlink_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_SYMLINK);
@@ -470,7 +492,9 @@ symlink_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -506,15 +530,18 @@ process_readlink(uv_fs_t* req, PyObject **path, PyObject **errorno)
 
 static void
 readlink_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     process_readlink(req, &path, &errorno);
     callback = (PyObject *)req->data;
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -533,9 +560,10 @@ readlink_cb(uv_fs_t* req) {
 
 static void
 chown_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_CHOWN || req->fs_type == UV_FS_FCHOWN);
@@ -557,7 +585,9 @@ chown_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -600,15 +630,18 @@ process_open(uv_fs_t* req, PyObject **path, PyObject **fd, PyObject **errorno)
 
 static void
 open_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *fd, *errorno, *path;
+    uint64_t start;
 
     process_open(req, &path, &fd, &errorno);
     callback = (PyObject *)req->data;
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, fd, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call4(callback, (PyObject *)loop, path, fd, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -628,9 +661,10 @@ open_cb(uv_fs_t* req) {
 
 static void
 close_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_CLOSE);
@@ -652,7 +686,9 @@ close_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -704,16 +740,19 @@ process_read(uv_fs_t* req, PyObject **path, PyObject **read_data, PyObject **err
 
 static void
 read_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     fs_rwreq_data_t *req_data;
     Loop *loop;
     PyObject *result, *errorno, *read_data, *path;
+    uint64_t start;
 
     process_read(req, &path, &read_data, &errorno);
     req_data = (fs_rwreq_data_t*)(req->data);
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(req_data->callback, loop, path, read_data, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call4(req_data->callback, (PyObject *)loop, path, read_data, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, req_data->callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -756,10 +795,11 @@ process_write(uv_fs_t* req, PyObject **path, PyObject **bytes_written, PyObject
 
 static void
 write_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     fs_rwreq_data_t *req_data;
     Loop *loop;
     PyObject *result, *errorno, *bytes_written, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_WRITE);
@@ -768,7 +808,9 @@ write_cb(uv_fs_t* req) {
     req_data = (fs_rwreq_data_t*)(req->data);
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(req_data->callback, loop, path, bytes_written, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call4(req_data->callback, (PyObject *)loop, path, bytes_written, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, req_data->callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -790,9 +832,10 @@ write_cb(uv_fs_t* req) {
 
 static void
 fsync_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_FSYNC || req->fs_type == UV_FS_FDATASYNC);
@@ -814,7 +857,9 @@ fsync_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -833,9 +878,10 @@ fsync_cb(uv_fs_t* req) {
 
 static void
 ftruncate_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
 
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_FTRUNCATE);
@@ -857,7 +903,9 @@ ftruncate_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -919,15 +967,18 @@ process_readdir(uv_fs_t* req, PyObject **path, PyObject **files, PyObject **erro
 
 static void
 readdir_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *files, *path;
+    uint64_t start;
 
     process_readdir(req, &path, &files, &errorno);
     callback = (PyObject *)req->data;
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, files, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call4(callback, (PyObject *)loop, path, files, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -970,15 +1021,18 @@ process_sendfile(uv_fs_t* req, PyObject **path, PyObject **bytes_written, PyObje
 
 static void
 sendfile_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *bytes_written, *path;
+    uint64_t start;
 
     process_sendfile(req, &path, &bytes_written, &errorno);
     callback = (PyObject *)req->data;
     loop = (Loop *)req->loop->data;
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, bytes_written, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call4(callback, (PyObject *)loop, path, bytes_written, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -998,9 +1052,10 @@ sendfile_cb(uv_fs_t* req) {
 
 static void
 utime_cb(uv_fs_t* req) {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     Loop *loop;
     PyObject *callback, *result, *errorno, *path;
+    uint64_t start;
     ASSERT(req);
     ASSERT(req->fs_type == UV_FS_UTIME || req->fs_type == UV_FS_FUTIME);
 
@@ -1021,7 +1076,9 @@ utime_cb(uv_fs_t* req) {
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, loop, path, errorno, NULL);
+    start = pyuv_metrics_start(req->loop);
+    result = pyuv_call3(callback, (PyObject *)loop, path, errorno);
+    pyuv_metrics_end(req->loop, PYUV_METRIC_FS, start, (PyObject *)loop, callback);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -2428,9 +2485,10 @@ FS_methods[] = {
 static void
 on_fsevent_callback(uv_fs_event_t *handle, const char *filename, int events, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     FSEvent *self;
     PyObject *result, *py_filename, *py_events, *errorno;
+    uint64_t start;
 
     ASSERT(handle);
 
@@ -2456,7 +2514,9 @@ on_fsevent_callback(uv_fs_event_t *handle, const char *filename, int events, int
 
     py_events = PyInt_FromLong((long)events);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, py_filename, py_events, errorno, NULL);
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call4(self->callback, (PyObject *)self, py_filename, py_events, errorno);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_FS, start, (PyObject *)self, self->callback);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -2496,18 +2556,13 @@ FSEvent_func_start(FSEvent *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
-    fs_event = PyMem_Malloc(sizeof(uv_fs_event_t));
-    if (!fs_event) {
-        PyErr_NoMemory();
-        return NULL;
-    }
+    fs_event = &self->fs_event_h;
     fs_event->data = (void *)self;
     UV_HANDLE(self) = (uv_handle_t *)fs_event;
 
     r = uv_fs_event_init(UV_HANDLE_LOOP(self), fs_event, path, on_fsevent_callback, flags);
     if (r != 0) {
         RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_FSEventError);
-        PyMem_Free(fs_event);
         UV_HANDLE(self) = NULL;
         return NULL;
     }
@@ -2648,9 +2703,10 @@ static PyTypeObject FSEventType = {
 static void
 on_fspoll_callback(uv_fs_poll_t *handle, int status, const uv_statbuf_t *prev, const uv_statbuf_t *curr)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     FSPoll *self;
     PyObject *result, *errorno, *prev_stat_data, *curr_stat_data;
+    uint64_t start;
 
     ASSERT(handle);
 
@@ -2687,7 +2743,9 @@ on_fspoll_callback(uv_fs_poll_t *handle, int status, const uv_statbuf_t *prev, c
         }
     }
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, prev_stat_data, curr_stat_data, errorno, NULL);
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call4(self->callback, (PyObject *)self, prev_stat_data, curr_stat_data, errorno);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_FS, start, (PyObject *)self, self->callback);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -2785,12 +2843,7 @@ FSPoll_tp_init(FSPoll *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_fspoll = PyMem_Malloc(sizeof(uv_fs_poll_t));
-    if (!uv_fspoll) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_fspoll = &self->fs_poll_h;
 
     r = uv_fs_poll_init(UV_HANDLE_LOOP(self), uv_fspoll);
     if (r != 0) {
@@ -1,8 +1,113 @@
 
+/*
+ * Free lists: the memory of deallocated TCP, Pipe and Timer objects (which includes the
+ * libuv handle) is kept and reused for new objects of the same type, up to the configured
+ * number of objects per type. Subclasses are not cached.
+ */
+
+static handle_freelist_t handle_freelists[] = {
+    { &TCPType, NULL, 0 },
+    { &PipeType, NULL, 0 },
+    { &TimerType, NULL, 0 },
+    { NULL }
+};
+
+static Py_ssize_t handle_freelist_size = PYUV_DEFAULT_FREELIST_SIZE;
+
+
+static INLINE handle_freelist_t *
+handle_freelist_get(PyTypeObject *type)
+{
+    handle_freelist_t *freelist;
+
+    for (freelist = handle_freelists; freelist->type; freelist++) {
+        if (freelist->type == type) {
+            return freelist;
+        }
+    }
+    return NULL;
+}
+
+
+/* keep the memory of an object which is being deallocated, returns False if it has to be freed */
+static Bool
+handle_freelist_push(PyObject *obj)
+{
+    handle_freelist_t *freelist;
+
+    freelist = handle_freelist_get(Py_TYPE(obj));
+    if (!freelist || freelist->len >= handle_freelist_size) {
+        return False;
+    }
+
+    if (!freelist->items) {
+        freelist->items = PyMem_Malloc(sizeof(PyObject *) * handle_freelist_size);
+        if (!freelist->items) {
+            return False;
+        }
+    }
+
+    PyObject_GC_UnTrack(obj);
+    freelist->items[freelist->len++] = obj;
+    return True;
+}
+
+
+/* get an object from the free list, initialized as PyType_GenericAlloc would do it */
+static PyObject *
+handle_freelist_pop(PyTypeObject *type)
+{
+    PyObject *obj;
+    handle_freelist_t *freelist;
+
+    freelist = handle_freelist_get(type);
+    if (!freelist || freelist->len == 0) {
+        return NULL;
+    }
+
+    obj = freelist->items[--freelist->len];
+    memset((char *)obj + sizeof(PyObject), 0, type->tp_basicsize - sizeof(PyObject));
+    PyObject_INIT(obj, type);
+    PyObject_GC_Track(obj);
+    return obj;
+}
+
+
+/* change the maximum number of objects kept per type, objects above the new limit are freed */
+static int
+handle_freelist_resize(Py_ssize_t size)
+{
+    PyObject **items;
+    handle_freelist_t *freelist;
+
+    for (freelist = handle_freelists; freelist->type; freelist++) {
+        while (freelist->len > size) {
+            PyObject_GC_Del(freelist->items[--freelist->len]);
+        }
+        if (freelist->items) {
+            if (size == 0) {
+                PyMem_Free(freelist->items);
+                freelist->items = NULL;
+            } else {
+                items = PyMem_Realloc(freelist->items, sizeof(PyObject *) * size);
+                if (!items) {
+                    PyErr_NoMemory();
+                    return -1;
+                }
+                freelist->items = items;
+            }
+        }
+    }
+
+    handle_freelist_size = size;
+    return 0;
+}
+
+
 static void
 on_handle_close(uv_handle_t *handle)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     Handle *self;
     PyObject *result;
     ASSERT(handle);
@@ -11,7 +116,7 @@ on_handle_close(uv_handle_t *handle)
     ASSERT(self);
 
     if (self->on_close_cb) {
-        result = PyObject_CallFunctionObjArgs(self->on_close_cb, self, NULL);
+        result = pyuv_call1(self->on_close_cb, (PyObject *)self);
         if (result == NULL) {
             print_uncaught_exception();
         }
@@ -20,7 +125,10 @@ on_handle_close(uv_handle_t *handle)
 
     self->uv_handle = NULL;
     handle->data = NULL;
-    PyMem_Free(handle);
+    if (self->uv_handle_external) {
+        self->uv_handle_external = False;
+        PyMem_Free(handle);
+    }
 
     Py_XDECREF(self->on_close_cb);
     self->on_close_cb = NULL;
@@ -35,7 +143,7 @@ on_handle_close(uv_handle_t *handle)
 static void
 on_handle_dealloc_close(uv_handle_t *handle)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     ASSERT(handle);
     handle->data = NULL;
     PyMem_Free(handle);
@@ -43,6 +151,24 @@ on_handle_dealloc_close(uv_handle_t *handle)
 }
 
 
+/* the object was deallocated while its handle was open, its memory is released now */
+static void
+on_handle_embedded_dealloc_close(uv_handle_t *handle)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    PyObject *self;
+
+    ASSERT(handle);
+    self = (PyObject *)handle->data;
+    ASSERT(self);
+    handle->data = NULL;
+    if (!handle_freelist_push(self)) {
+        PyObject_GC_Del(self);
+    }
+    PyGILState_Release(gstate);
+}
+
+
 static PyObject *
 Handle_func_ref(Handle *self)
 {
@@ -120,9 +246,12 @@ Handle_closed_get(Handle *self, void *closure)
 static PyObject *
 Handle_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 {
-    Handle *self = (Handle *)PyType_GenericNew(type, args, kwargs);
+    Handle *self = (Handle *)handle_freelist_pop(type);
     if (!self) {
-        return NULL;
+        self = (Handle *)PyType_GenericNew(type, args, kwargs);
+        if (!self) {
+            return NULL;
+        }
     }
     self->uv_handle = NULL;
     self->weakreflist = NULL;
@@ -153,14 +282,27 @@ Handle_tp_clear(Handle *self)
 static void
 Handle_tp_dealloc(Handle *self)
 {
+    Bool keep_memory = False;
+
     if (self->uv_handle) {
-        uv_close(self->uv_handle, on_handle_dealloc_close);
+        if (self->uv_handle_external) {
+            uv_close(self->uv_handle, on_handle_dealloc_close);
+        } else {
+            /* the handle lives in the object and libuv uses it until the close callback runs,
+             * the memory is released there (walk callbacks skip objects with a refcount of 0) */
+            PyObject_GC_UnTrack(self);
+            self->uv_handle->data = (void *)self;
+            uv_close(self->uv_handle, on_handle_embedded_dealloc_close);
+            keep_memory = True;
+        }
     }
     if (self->weakreflist != NULL) {
         PyObject_ClearWeakRefs((PyObject *)self);
     }
     Py_TYPE(self)->tp_clear((PyObject *)self);
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    if (!keep_memory && !handle_freelist_push((PyObject *)self)) {
+        Py_TYPE(self)->tp_free((PyObject *)self);
+    }
 }
 
 
@@ -0,0 +1,303 @@
+
+/*
+ * Log-linear histograms, used for recording callback latencies. Recording a value is a
+ * couple of shifts and an increment, percentiles are computed by walking the buckets.
+ * Values are stored in nanoseconds and exposed in seconds.
+ */
+
+/* lowest and highest value which fall in the given bucket */
+static INLINE uint64_t
+histogram_bucket_low(unsigned int index)
+{
+    unsigned int shift;
+
+    if (index < (2 << HISTOGRAM_SUB_BITS)) {
+        return index;
+    }
+    shift = (index >> HISTOGRAM_SUB_BITS) - 1;
+    return (uint64_t)((index & ((1 << HISTOGRAM_SUB_BITS) - 1)) + (1 << HISTOGRAM_SUB_BITS)) << shift;
+}
+
+
+static INLINE uint64_t
+histogram_bucket_high(unsigned int index)
+{
+    if (index < (2 << HISTOGRAM_SUB_BITS)) {
+        return index;
+    }
+    return histogram_bucket_low(index) + ((uint64_t)1 << ((index >> HISTOGRAM_SUB_BITS) - 1)) - 1;
+}
+
+
+static void
+histogram_reset(histogram_t *hist)
+{
+    memset(hist, 0, sizeof(histogram_t));
+}
+
+
+static void
+histogram_merge(histogram_t *dst, const histogram_t *src)
+{
+    int i;
+
+    if (src->count == 0) {
+        return;
+    }
+    if (dst->count == 0 || src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+}
+
+
+/* value below which the given percentage of the recorded values fall, with the precision of a bucket */
+static uint64_t
+histogram_percentile(const histogram_t *hist, double percentile)
+{
+    int i;
+    uint64_t target, total, value;
+
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    target = (uint64_t)(percentile / 100.0 * (double)hist->count + 0.5);
+    if (target == 0) {
+        target = 1;
+    } else if (target > hist->count) {
+        target = hist->count;
+    }
+
+    total = 0;
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        total += hist->buckets[i];
+        if (total >= target) {
+            break;
+        }
+    }
+
+    value = histogram_bucket_high(i);
+    if (value > hist->max) {
+        value = hist->max;
+    }
+    if (value < hist->min) {
+        value = hist->min;
+    }
+    return value;
+}
+
+
+/* create a Histogram object holding a copy of the given histogram */
+static PyObject *
+Histogram_from_histogram(const histogram_t *hist)
+{
+    Histogram *self;
+
+    self = (Histogram *)HistogramType.tp_alloc(&HistogramType, 0);
+    if (!self) {
+        return NULL;
+    }
+    memcpy(&self->hist, hist, sizeof(histogram_t));
+    return (PyObject *)self;
+}
+
+
+static PyObject *
+Histogram_func_record(Histogram *self, PyObject *args)
+{
+    double value;
+
+    if (!PyArg_ParseTuple(args, "d:record", &value)) {
+        return NULL;
+    }
+
+    if (value < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    histogram_record(&self->hist, (uint64_t)(value * 1e9));
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Histogram_func_percentile(Histogram *self, PyObject *args)
+{
+    double percentile;
+
+    if (!PyArg_ParseTuple(args, "d:percentile", &percentile)) {
+        return NULL;
+    }
+
+    if (percentile < 0.0 || percentile > 100.0) {
+        PyErr_SetString(PyExc_ValueError, "percentile must be between 0 and 100");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(histogram_percentile(&self->hist, percentile) / 1e9);
+}
+
+
+static PyObject *
+Histogram_func_merge(Histogram *self, PyObject *args)
+{
+    Histogram *other;
+
+    if (!PyArg_ParseTuple(args, "O!:merge", &HistogramType, &other)) {
+        return NULL;
+    }
+
+    histogram_merge(&self->hist, &other->hist);
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Histogram_func_reset(Histogram *self)
+{
+    histogram_reset(&self->hist);
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Histogram_func_copy(Histogram *self)
+{
+    return Histogram_from_histogram(&self->hist);
+}
+
+
+static PyObject *
+Histogram_count_get(Histogram *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)self->hist.count);
+}
+
+
+static PyObject *
+Histogram_min_get(Histogram *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyFloat_FromDouble(self->hist.min / 1e9);
+}
+
+
+static PyObject *
+Histogram_max_get(Histogram *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyFloat_FromDouble(self->hist.max / 1e9);
+}
+
+
+static PyObject *
+Histogram_mean_get(Histogram *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    if (self->hist.count == 0) {
+        return PyFloat_FromDouble(0.0);
+    }
+    return PyFloat_FromDouble((double)self->hist.sum / (double)self->hist.count / 1e9);
+}
+
+
+static PyObject *
+Histogram_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    Histogram *self;
+
+    UNUSED_ARG(kwargs);
+
+    if (!PyArg_ParseTuple(args, ":__new__")) {
+        return NULL;
+    }
+
+    self = (Histogram *)type->tp_alloc(type, 0);
+    if (!self) {
+        return NULL;
+    }
+    histogram_reset(&self->hist);
+    return (PyObject *)self;
+}
+
+
+static void
+Histogram_tp_dealloc(Histogram *self)
+{
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+
+static PyMethodDef
+Histogram_tp_methods[] = {
+    { "record", (PyCFunction)Histogram_func_record, METH_VARARGS, "Record a value (in seconds)." },
+    { "percentile", (PyCFunction)Histogram_func_percentile, METH_VARARGS, "Return the value (in seconds) below which the given percentage of the recorded values fall." },
+    { "merge", (PyCFunction)Histogram_func_merge, METH_VARARGS, "Add the values recorded in another histogram to this one." },
+    { "reset", (PyCFunction)Histogram_func_reset, METH_NOARGS, "Remove all recorded values." },
+    { "copy", (PyCFunction)Histogram_func_copy, METH_NOARGS, "Return a copy of this histogram." },
+    { NULL }
+};
+
+
+static PyGetSetDef Histogram_tp_getsets[] = {
+    {"count", (getter)Histogram_count_get, NULL, "Number of recorded values.", NULL},
+    {"min", (getter)Histogram_min_get, NULL, "Lowest recorded value (in seconds).", NULL},
+    {"max", (getter)Histogram_max_get, NULL, "Highest recorded value (in seconds).", NULL},
+    {"mean", (getter)Histogram_mean_get, NULL, "Mean of the recorded values (in seconds).", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject HistogramType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.Histogram",                                               /*tp_name*/
+    sizeof(Histogram),                                              /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)Histogram_tp_dealloc,                               /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,                                             /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    0,                                                              /*tp_traverse*/
+    0,                                                              /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    Histogram_tp_methods,                                           /*tp_methods*/
+    0,                                                              /*tp_members*/
+    Histogram_tp_getsets,                                           /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    0,                                                              /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    Histogram_tp_new,                                               /*tp_new*/
+};
+
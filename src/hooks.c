@@ -0,0 +1,325 @@
+
+/*
+ * Prepare, check and idle hooks. All hooks of a kind registered on a loop share a single
+ * libuv handle and run one after the other, ordered by priority, with a single GIL
+ * acquisition. The registered hooks are kept in a tuple which is replaced (never modified)
+ * when hooks are added or removed, so hooks can add or remove hooks while they run.
+ */
+
+static const char *loop_hook_names[PYUV_HOOK_KINDS] = { "prepare", "check", "idle" };
+
+
+static void
+loop_hooks_run(loop_hooks_t *hooks)
+{
+    Py_ssize_t i;
+    Loop *loop;
+    PyObject *entries, *result;
+
+    loop = hooks->loop;
+    entries = hooks->hooks;
+    if (!entries) {
+        return;
+    }
+
+    Py_INCREF(loop);
+    Py_INCREF(entries);
+
+    for (i = 0; i < PyTuple_GET_SIZE(entries); i++) {
+        result = pyuv_call1(PyTuple_GET_ITEM(PyTuple_GET_ITEM(entries, i), 1), (PyObject *)loop);
+        if (result == NULL) {
+            handle_uncaught_exception(loop);
+        }
+        Py_XDECREF(result);
+    }
+
+    Py_DECREF(entries);
+    Py_DECREF(loop);
+}
+
+
+static void
+on_loop_prepare_hooks(uv_prepare_t *handle, int status)
+{
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    UNUSED_ARG(status);
+    loop_hooks_run((loop_hooks_t *)handle);
+    PyGILState_Release(gstate);
+}
+
+
+static void
+on_loop_check_hooks(uv_check_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    UNUSED_ARG(status);
+    loop_hooks_run((loop_hooks_t *)handle);
+    PyGILState_Release(gstate);
+}
+
+
+static void
+on_loop_idle_hooks(uv_idle_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    UNUSED_ARG(status);
+    loop_hooks_run((loop_hooks_t *)handle);
+    PyGILState_Release(gstate);
+}
+
+
+static loop_hooks_t *
+loop_hooks_new(Loop *loop, int kind)
+{
+    int r;
+    loop_hooks_t *hooks;
+
+    hooks = (loop_hooks_t *)PyMem_Malloc(sizeof(loop_hooks_t));
+    if (!hooks) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    switch (kind) {
+        case PYUV_HOOK_PREPARE:
+            r = uv_prepare_init(loop->uv_loop, &hooks->handle.prepare);
+            break;
+        case PYUV_HOOK_CHECK:
+            r = uv_check_init(loop->uv_loop, &hooks->handle.check);
+            break;
+        default:
+            r = uv_idle_init(loop->uv_loop, &hooks->handle.idle);
+            break;
+    }
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(loop->uv_loop, PyExc_UVError);
+        PyMem_Free(hooks);
+        return NULL;
+    }
+    /* internal handle: it's not visible to Loop.walk and hooks don't keep the loop alive */
+    ((uv_handle_t *)hooks)->data = NULL;
+    uv_unref((uv_handle_t *)hooks);
+
+    hooks->loop = loop;
+    hooks->kind = kind;
+    hooks->hooks = NULL;
+
+    return hooks;
+}
+
+
+static void
+loop_hooks_start(loop_hooks_t *hooks)
+{
+    switch (hooks->kind) {
+        case PYUV_HOOK_PREPARE:
+            uv_prepare_start(&hooks->handle.prepare, on_loop_prepare_hooks);
+            break;
+        case PYUV_HOOK_CHECK:
+            uv_check_start(&hooks->handle.check, on_loop_check_hooks);
+            break;
+        default:
+            uv_idle_start(&hooks->handle.idle, on_loop_idle_hooks);
+            break;
+    }
+}
+
+
+static void
+loop_hooks_stop(loop_hooks_t *hooks)
+{
+    switch (hooks->kind) {
+        case PYUV_HOOK_PREPARE:
+            uv_prepare_stop(&hooks->handle.prepare);
+            break;
+        case PYUV_HOOK_CHECK:
+            uv_check_stop(&hooks->handle.check);
+            break;
+        default:
+            uv_idle_stop(&hooks->handle.idle);
+            break;
+    }
+}
+
+
+static int
+loop_hooks_traverse(loop_hooks_t *hooks, visitproc visit, void *arg)
+{
+    Py_VISIT(hooks->hooks);
+    return 0;
+}
+
+
+/* remove all hooks */
+static void
+loop_hooks_clear(loop_hooks_t *hooks)
+{
+    loop_hooks_stop(hooks);
+    Py_CLEAR(hooks->hooks);
+}
+
+
+/* free the hooks memory after the loop they were running on has been deleted */
+static void
+loop_hooks_destroy(loop_hooks_t *hooks)
+{
+    Py_XDECREF(hooks->hooks);
+    PyMem_Free(hooks);
+}
+
+
+static PyObject *
+loop_add_hook(Loop *self, PyObject *args, PyObject *kwargs, int kind, const char *format)
+{
+    int priority;
+    Py_ssize_t i, n, pos;
+    PyObject *callback, *entry, *item, *entries;
+    loop_hooks_t *hooks;
+
+    static char *kwlist[] = {"callback", "priority", NULL};
+
+    priority = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, format, kwlist, &callback, &priority)) {
+        return NULL;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (!self->hooks[kind]) {
+        self->hooks[kind] = loop_hooks_new(self, kind);
+        if (!self->hooks[kind]) {
+            return NULL;
+        }
+    }
+    hooks = self->hooks[kind];
+
+    entry = Py_BuildValue("(iO)", priority, callback);
+    if (!entry) {
+        return NULL;
+    }
+
+    n = hooks->hooks ? PyTuple_GET_SIZE(hooks->hooks) : 0;
+    entries = PyTuple_New(n + 1);
+    if (!entries) {
+        Py_DECREF(entry);
+        return NULL;
+    }
+
+    /* hooks with the same priority run in the order they were added */
+    for (pos = 0; pos < n; pos++) {
+        if (PyInt_AsSsize_t(PyTuple_GET_ITEM(PyTuple_GET_ITEM(hooks->hooks, pos), 0)) > priority) {
+            break;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        item = PyTuple_GET_ITEM(hooks->hooks, i);
+        Py_INCREF(item);
+        PyTuple_SET_ITEM(entries, i < pos ? i : i + 1, item);
+    }
+    PyTuple_SET_ITEM(entries, pos, entry);
+
+    Py_XDECREF(hooks->hooks);
+    hooks->hooks = entries;
+
+    if (n == 0) {
+        loop_hooks_start(hooks);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+loop_remove_hook(Loop *self, PyObject *callback, int kind)
+{
+    int r;
+    Py_ssize_t i, n, pos;
+    PyObject *item, *entries;
+    loop_hooks_t *hooks;
+
+    hooks = self->hooks[kind];
+    n = (hooks && hooks->hooks) ? PyTuple_GET_SIZE(hooks->hooks) : 0;
+
+    for (pos = 0; pos < n; pos++) {
+        r = PyObject_RichCompareBool(PyTuple_GET_ITEM(PyTuple_GET_ITEM(hooks->hooks, pos), 1), callback, Py_EQ);
+        if (r == -1) {
+            return NULL;
+        } else if (r == 1) {
+            break;
+        }
+    }
+
+    if (pos == n) {
+        PyErr_Format(PyExc_ValueError, "%s hook is not registered", loop_hook_names[kind]);
+        return NULL;
+    }
+
+    entries = PyTuple_New(n - 1);
+    if (!entries) {
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        if (i == pos) {
+            continue;
+        }
+        item = PyTuple_GET_ITEM(hooks->hooks, i);
+        Py_INCREF(item);
+        PyTuple_SET_ITEM(entries, i < pos ? i : i - 1, item);
+    }
+
+    Py_DECREF(hooks->hooks);
+    hooks->hooks = entries;
+
+    if (n == 1) {
+        loop_hooks_stop(hooks);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Loop_func_add_prepare_hook(Loop *self, PyObject *args, PyObject *kwargs)
+{
+    return loop_add_hook(self, args, kwargs, PYUV_HOOK_PREPARE, "O|i:add_prepare_hook");
+}
+
+
+static PyObject *
+Loop_func_remove_prepare_hook(Loop *self, PyObject *callback)
+{
+    return loop_remove_hook(self, callback, PYUV_HOOK_PREPARE);
+}
+
+
+static PyObject *
+Loop_func_add_check_hook(Loop *self, PyObject *args, PyObject *kwargs)
+{
+    return loop_add_hook(self, args, kwargs, PYUV_HOOK_CHECK, "O|i:add_check_hook");
+}
+
+
+static PyObject *
+Loop_func_remove_check_hook(Loop *self, PyObject *callback)
+{
+    return loop_remove_hook(self, callback, PYUV_HOOK_CHECK);
+}
+
+
+static PyObject *
+Loop_func_add_idle_hook(Loop *self, PyObject *args, PyObject *kwargs)
+{
+    return loop_add_hook(self, args, kwargs, PYUV_HOOK_IDLE, "O|i:add_idle_hook");
+}
+
+
+static PyObject *
+Loop_func_remove_idle_hook(Loop *self, PyObject *callback)
+{
+    return loop_remove_hook(self, callback, PYUV_HOOK_IDLE);
+}
+
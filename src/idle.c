@@ -2,7 +2,7 @@
 static void
 on_idle_callback(uv_idle_t *handle, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     Idle *self;
     PyObject *result;
 
@@ -14,7 +14,7 @@ on_idle_callback(uv_idle_t *handle, int status)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, NULL);
+    result = pyuv_call1(self->callback, (PyObject *)self);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -103,12 +103,7 @@ Idle_tp_init(Idle *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_idle = PyMem_Malloc(sizeof(uv_idle_t));
-    if (!uv_idle) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_idle = &self->idle_h;
 
     r = uv_idle_init(UV_HANDLE_LOOP(self), uv_idle);
     if (r != 0) {
@@ -1,6 +1,9 @@
 
 static Loop *default_loop = NULL;
 
+/* loop running in (or assigned to) the current thread, borrowed reference */
+static PYUV_THREAD_LOCAL Loop *current_loop = NULL;
+
 
 static void
 _loop_cleanup(void)
@@ -9,9 +12,116 @@ _loop_cleanup(void)
 }
 
 
+/* the internal handles used by Loop.run don't keep the loop alive and are not visible to Loop.walk */
+static void
+on_loop_gil_prepare(uv_prepare_t *handle, int status)
+{
+    Loop *loop = container_of(handle, Loop, gil_prepare);
+
+    UNUSED_ARG(status);
+
+    /* the GIL is only held between uv_run_once calls and while dispatching callbacks */
+    if (!loop->gil_tstate) {
+        loop->gil_tstate = PyEval_SaveThread();
+    }
+}
+
+
+static void
+on_loop_gil_check(uv_check_t *handle, int status)
+{
+    PyThreadState *tstate;
+    Loop *loop = container_of(handle, Loop, gil_check);
+
+    UNUSED_ARG(status);
+
+    if (loop->gil_tstate) {
+        tstate = loop->gil_tstate;
+        loop->gil_tstate = NULL;
+        PyEval_RestoreThread(tstate);
+    }
+}
+
+
+static void
+init_loop_run_handles(Loop *self, char *read_slab)
+{
+    uv_idle_init(self->uv_loop, &self->run_idle);
+    self->run_idle.data = NULL;
+    uv_unref((uv_handle_t *)&self->run_idle);
+    uv_timer_init(self->uv_loop, &self->run_timer);
+    self->run_timer.data = NULL;
+    uv_unref((uv_handle_t *)&self->run_timer);
+    uv_prepare_init(self->uv_loop, &self->gil_prepare);
+    self->gil_prepare.data = NULL;
+    uv_unref((uv_handle_t *)&self->gil_prepare);
+    uv_check_init(self->uv_loop, &self->gil_check);
+    self->gil_check.data = NULL;
+    uv_unref((uv_handle_t *)&self->gil_check);
+    self->gil_tstate = NULL;
+    uv_async_init(self->uv_loop, &self->threadsafe_async, on_threadsafe_async);
+    self->threadsafe_async.data = NULL;
+    uv_unref((uv_handle_t *)&self->threadsafe_async);
+    self->threadsafe_calls = NULL;
+    self->read_slab = read_slab;
+}
+
+
+/* buffer for stream and UDP reads, shared by all handles in the loop: data is always
+ * consumed by the read callback before the next read starts. Called without the GIL.
+ * The buffer is allocated together with the loop, libuv asserts that it's not empty. */
+static uv_buf_t
+loop_read_buffer(uv_loop_t *uv_loop)
+{
+    Loop *loop = (Loop *)uv_loop->data;
+
+    ASSERT(loop);
+    ASSERT(loop->read_slab);
+    return uv_buf_init(loop->read_slab, PYUV_READ_SLAB_SIZE);
+}
+
+
+/* close the internal handles and let libuv finish closing them, before the loop is deleted.
+ * Nothing else can be active: pyuv handles and requests keep a reference to their loop,
+ * so a single iteration runs the close callbacks without blocking for I/O. */
+static void
+close_loop_internal_handles(Loop *self)
+{
+    int i;
+
+    uv_close((uv_handle_t *)&self->run_idle, NULL);
+    uv_close((uv_handle_t *)&self->run_timer, NULL);
+    uv_close((uv_handle_t *)&self->gil_prepare, NULL);
+    uv_close((uv_handle_t *)&self->gil_check, NULL);
+    uv_close((uv_handle_t *)&self->threadsafe_async, NULL);
+    if (self->stream_timeouts) {
+        uv_close((uv_handle_t *)&self->stream_timeouts->timer_handle, NULL);
+    }
+    if (self->call_queue) {
+        uv_close((uv_handle_t *)&self->call_queue->timer_handle, NULL);
+    }
+    if (self->ready_queue) {
+        uv_close((uv_handle_t *)&self->ready_queue->idle_handle, NULL);
+    }
+    if (self->metrics) {
+        uv_close((uv_handle_t *)&self->metrics->prepare_handle, NULL);
+        uv_close((uv_handle_t *)&self->metrics->check_handle, NULL);
+    }
+    for (i = 0; i < PYUV_HOOK_KINDS; i++) {
+        if (self->hooks[i]) {
+            uv_close((uv_handle_t *)&self->hooks[i]->handle, NULL);
+        }
+    }
+
+    uv_run_once(self->uv_loop);
+}
+
+
 static PyObject *
 new_loop(PyTypeObject *type, PyObject *args, PyObject *kwargs, int is_default)
 {
+    char *read_slab;
+
     if ((args && PyTuple_GET_SIZE(args)) || (kwargs && PyDict_Check(kwargs) && PyDict_Size(kwargs))) {
         PyErr_SetString(PyExc_TypeError, "Loop initialization takes no parameters");
         return NULL;
@@ -19,8 +129,14 @@ new_loop(PyTypeObject *type, PyObject *args, PyObject *kwargs, int is_default)
 
     if (is_default) {
         if (!default_loop) {
+            read_slab = PyMem_Malloc(PYUV_READ_SLAB_SIZE);
+            if (!read_slab) {
+                PyErr_NoMemory();
+                return NULL;
+            }
             default_loop = (Loop *)PyType_GenericNew(type, args, kwargs);
             if (!default_loop) {
+                PyMem_Free(read_slab);
                 return NULL;
             }
             default_loop->uv_loop = uv_default_loop();
@@ -28,13 +144,21 @@ new_loop(PyTypeObject *type, PyObject *args, PyObject *kwargs, int is_default)
             default_loop->is_default = True;
             default_loop->weakreflist = NULL;
             default_loop->excepthook_cb = NULL;
+            init_loop_run_handles(default_loop, read_slab);
             Py_AtExit(_loop_cleanup);
         }
         Py_INCREF(default_loop);
         return (PyObject *)default_loop;
     } else {
-        Loop *self = (Loop *)PyType_GenericNew(type, args, kwargs);
+        Loop *self;
+        read_slab = PyMem_Malloc(PYUV_READ_SLAB_SIZE);
+        if (!read_slab) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        self = (Loop *)PyType_GenericNew(type, args, kwargs);
         if (!self) {
+            PyMem_Free(read_slab);
             return NULL;
         }
         self->uv_loop = uv_loop_new();
@@ -42,20 +166,110 @@ new_loop(PyTypeObject *type, PyObject *args, PyObject *kwargs, int is_default)
         self->is_default = False;
         self->weakreflist = NULL;
         self->excepthook_cb = NULL;
+        init_loop_run_handles(self, read_slab);
         return (PyObject *)self;
     }
 }
 
 
+static void
+on_loop_run_idle(uv_idle_t *handle, int status)
+{
+    /* nothing to do, an active idle handle makes the loop poll without blocking */
+    UNUSED_ARG(handle);
+    UNUSED_ARG(status);
+}
+
+
+static void
+on_loop_run_timer(uv_timer_t *handle, int status)
+{
+    /* nothing to do, the deadline is checked after each iteration */
+    UNUSED_ARG(handle);
+    UNUSED_ARG(status);
+}
+
+
 static PyObject *
-Loop_func_run(Loop *self)
+Loop_func_run(Loop *self, PyObject *args, PyObject *kwargs)
 {
-    Py_BEGIN_ALLOW_THREADS
-    uv_run(self->uv_loop);
-    Py_END_ALLOW_THREADS
+    int r, mode;
+    uint64_t deadline;
+    double timeout;
+    Loop *prev_loop;
+    PyObject *py_timeout, *hold_gil;
+
+    static char *kwlist[] = {"mode", "timeout", "hold_gil", NULL};
+
+    mode = PYUV_RUN_DEFAULT;
+    py_timeout = Py_None;
+    hold_gil = Py_False;
+    deadline = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iOO!:run", kwlist, &mode, &py_timeout, &PyBool_Type, &hold_gil)) {
+        return NULL;
+    }
+
+    if (mode != PYUV_RUN_DEFAULT && mode != PYUV_RUN_ONCE && mode != PYUV_RUN_NOWAIT) {
+        PyErr_SetString(PyExc_ValueError, "invalid run mode");
+        return NULL;
+    }
+
+    if (py_timeout != Py_None) {
+        timeout = PyFloat_AsDouble(py_timeout);
+        if (timeout == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (timeout < 0.0) {
+            PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+            return NULL;
+        }
+        deadline = uv_hrtime() + (uint64_t)(timeout * 1000000000);
+        uv_update_time(self->uv_loop);
+        /* round up, libuv timers have millisecond resolution */
+        uv_timer_start(&self->run_timer, on_loop_run_timer, (int64_t)(timeout * 1000 + 0.999), 0);
+    }
+
+    if (mode == PYUV_RUN_NOWAIT) {
+        uv_idle_start(&self->run_idle, on_loop_run_idle);
+    }
+
+    self->stop = 0;
+    prev_loop = current_loop;
+    current_loop = self;
+
+    if (hold_gil == Py_True) {
+        /* keep the GIL while dispatching callbacks, it's only released around the poll */
+        uv_prepare_start(&self->gil_prepare, on_loop_gil_prepare);
+        uv_check_start(&self->gil_check, on_loop_gil_check);
+        do {
+            r = uv_run_once(self->uv_loop);
+        } while (r && mode == PYUV_RUN_DEFAULT && !self->stop && (deadline == 0 || uv_hrtime() < deadline));
+        uv_prepare_stop(&self->gil_prepare);
+        uv_check_stop(&self->gil_check);
+    } else {
+        Py_BEGIN_ALLOW_THREADS
+        do {
+            r = uv_run_once(self->uv_loop);
+        } while (r && mode == PYUV_RUN_DEFAULT && !self->stop && (deadline == 0 || uv_hrtime() < deadline));
+        Py_END_ALLOW_THREADS
+    }
+
+    current_loop = prev_loop;
+    uv_idle_stop(&self->run_idle);
+    uv_timer_stop(&self->run_timer);
+
     if (PyErr_Occurred()) {
         handle_uncaught_exception(self);
     }
+    return PyBool_FromLong((long)r);
+}
+
+
+static PyObject *
+Loop_func_stop(Loop *self)
+{
+    self->stop = 1;
     Py_RETURN_NONE;
 }
 
@@ -64,10 +278,35 @@ static PyObject *
 Loop_func_run_once(Loop *self)
 {
     int r;
+    Loop *prev_loop;
 
+    prev_loop = current_loop;
+    current_loop = self;
     Py_BEGIN_ALLOW_THREADS
     r = uv_run_once(self->uv_loop);
     Py_END_ALLOW_THREADS
+    current_loop = prev_loop;
+    if (PyErr_Occurred()) {
+        handle_uncaught_exception(self);
+    }
+    return PyBool_FromLong((long)r);
+}
+
+
+/* For embedding the loop in another event loop: run a single iteration without blocking, the
+ * GIL is kept since the loop doesn't wait for I/O, so all callbacks share it */
+static PyObject *
+Loop_func_process_events(Loop *self)
+{
+    int r;
+    Loop *prev_loop;
+
+    prev_loop = current_loop;
+    current_loop = self;
+    uv_idle_start(&self->run_idle, on_loop_run_idle);
+    r = uv_run_once(self->uv_loop);
+    uv_idle_stop(&self->run_idle);
+    current_loop = prev_loop;
     if (PyErr_Occurred()) {
         handle_uncaught_exception(self);
     }
@@ -78,7 +317,14 @@ Loop_func_run_once(Loop *self)
 static PyObject *
 Loop_func_now(Loop *self)
 {
-    return PyLong_FromDouble(uv_now(self->uv_loop));
+    return PyLong_FromLongLong((PY_LONG_LONG)uv_now(self->uv_loop));
+}
+
+
+static PyObject *
+Loop_func_now_ns(Loop *self)
+{
+    return PyLong_FromLongLong((PY_LONG_LONG)uv_now(self->uv_loop) * 1000000);
 }
 
 
@@ -98,7 +344,7 @@ walk_cb(uv_handle_t* handle, void* arg)
     PyObject *obj = (PyObject *)handle->data;
     if (obj && Py_REFCNT(obj) > 0) {
         Py_INCREF(obj);
-        result = PyObject_CallFunctionObjArgs(callback, obj, NULL);
+        result = pyuv_call1(callback, obj);
         if (result == NULL) {
             /* TODO: check this... */
             handle_uncaught_exception(((Handle *)obj)->loop);
@@ -130,6 +376,53 @@ Loop_func_walk(Loop *self, PyObject *args)
 }
 
 
+static void
+tcp_info_walk_cb(uv_handle_t* handle, void* arg)
+{
+    PyObject *info, *item;
+    PyObject *result = (PyObject *)arg;
+    PyObject *obj = (PyObject *)handle->data;
+
+    if (handle->type != UV_TCP || !obj || Py_REFCNT(obj) <= 0 || uv_is_closing(handle) || PyErr_Occurred()) {
+        return;
+    }
+
+    info = pyuv_tcp_get_info((uv_tcp_t *)handle);
+    if (info == NULL) {
+        /* socket is not open or not connected yet, skip it */
+        PyErr_Clear();
+        return;
+    }
+
+    item = PyTuple_Pack(2, obj, info);
+    Py_DECREF(info);
+    if (item == NULL) {
+        return;
+    }
+    PyList_Append(result, item);
+    Py_DECREF(item);
+}
+
+static PyObject *
+Loop_func_get_tcp_info(Loop *self)
+{
+    PyObject *result;
+
+    result = PyList_New(0);
+    if (!result) {
+        return NULL;
+    }
+
+    uv_walk(self->uv_loop, (uv_walk_cb)tcp_info_walk_cb, (void*)result);
+    if (PyErr_Occurred()) {
+        Py_DECREF(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+
 static PyObject *
 Loop_func_default_loop(PyObject *cls)
 {
@@ -138,6 +431,18 @@ Loop_func_default_loop(PyObject *cls)
 }
 
 
+static PyObject *
+Loop_func_current(PyObject *cls)
+{
+    UNUSED_ARG(cls);
+    if (current_loop) {
+        Py_INCREF(current_loop);
+        return (PyObject *)current_loop;
+    }
+    return new_loop(&LoopType, NULL, NULL, 1);
+}
+
+
 static PyObject *
 Loop_default_get(Loop *self, void *closure)
 {
@@ -150,6 +455,29 @@ Loop_default_get(Loop *self, void *closure)
 }
 
 
+static PyObject *
+Loop_backend_fd_get(Loop *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyInt_FromLong((long)uv_backend_fd(self->uv_loop));
+}
+
+
+static PyObject *
+Loop_backend_timeout_get(Loop *self, void *closure)
+{
+    int timeout;
+
+    UNUSED_ARG(closure);
+
+    timeout = uv_backend_timeout(self->uv_loop);
+    if (timeout < 0) {
+        Py_RETURN_NONE;
+    }
+    return PyFloat_FromDouble(timeout / 1000.0);
+}
+
+
 static PyObject *
 Loop_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 {
@@ -160,7 +488,24 @@ Loop_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 static int
 Loop_tp_traverse(Loop *self, visitproc visit, void *arg)
 {
+    int i;
+
     Py_VISIT(self->dict);
+    if (self->call_queue) {
+        call_queue_traverse(self->call_queue, visit, arg);
+    }
+    if (self->ready_queue) {
+        ready_queue_traverse(self->ready_queue, visit, arg);
+    }
+    if (self->metrics) {
+        Py_VISIT(self->metrics->slow_callback_handler);
+    }
+    threadsafe_calls_traverse(self, visit, arg);
+    for (i = 0; i < PYUV_HOOK_KINDS; i++) {
+        if (self->hooks[i]) {
+            loop_hooks_traverse(self->hooks[i], visit, arg);
+        }
+    }
     return 0;
 }
 
@@ -168,7 +513,24 @@ Loop_tp_traverse(Loop *self, visitproc visit, void *arg)
 static int
 Loop_tp_clear(Loop *self)
 {
+    int i;
+
     Py_CLEAR(self->dict);
+    if (self->call_queue) {
+        call_queue_clear(self->call_queue);
+    }
+    if (self->ready_queue) {
+        ready_queue_clear(self->ready_queue);
+    }
+    if (self->metrics) {
+        Py_CLEAR(self->metrics->slow_callback_handler);
+    }
+    threadsafe_calls_clear(self);
+    for (i = 0; i < PYUV_HOOK_KINDS; i++) {
+        if (self->hooks[i]) {
+            loop_hooks_clear(self->hooks[i]);
+        }
+    }
     return 0;
 }
 
@@ -176,10 +538,36 @@ Loop_tp_clear(Loop *self)
 static void
 Loop_tp_dealloc(Loop *self)
 {
+    int i;
+
     if (self->uv_loop) {
+        close_loop_internal_handles(self);
         self->uv_loop->data = NULL;
         uv_loop_delete(self->uv_loop);
     }
+    if (self->stream_timeouts) {
+        timer_wheel_destroy(self->stream_timeouts);
+    }
+    if (self->call_queue) {
+        call_queue_destroy(self->call_queue);
+        self->call_queue = NULL;
+    }
+    if (self->ready_queue) {
+        ready_queue_destroy(self->ready_queue);
+        self->ready_queue = NULL;
+    }
+    if (self->metrics) {
+        loop_metrics_destroy(self->metrics);
+        /* Loop_tp_clear runs afterwards */
+        self->metrics = NULL;
+    }
+    for (i = 0; i < PYUV_HOOK_KINDS; i++) {
+        if (self->hooks[i]) {
+            loop_hooks_destroy(self->hooks[i]);
+            self->hooks[i] = NULL;
+        }
+    }
+    PyMem_Free(self->read_slab);
     if (self->weakreflist != NULL) {
         PyObject_ClearWeakRefs((PyObject *)self);
     }
@@ -258,14 +646,104 @@ Loop_excepthook_set(Loop *self, PyObject* val, void* c)
 }
 
 
+static PyObject*
+Loop_slack_get(Loop *self, void* c)
+{
+    UNUSED_ARG(c);
+    return PyFloat_FromDouble(self->call_slack / 1000.0);
+}
+
+
+static int
+Loop_slack_set(Loop *self, PyObject* val, void* c)
+{
+    double slack;
+
+    UNUSED_ARG(c);
+
+    if (val == NULL) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete attribute");
+        return -1;
+    }
+
+    slack = PyFloat_AsDouble(val);
+    if (slack == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+
+    if (slack < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "a positive float or 0.0 is required");
+        return -1;
+    }
+
+    self->call_slack = (uint64_t)(slack * 1000);
+    return 0;
+}
+
+
+static PyObject*
+Loop_call_soon_limit_get(Loop *self, void* c)
+{
+    UNUSED_ARG(c);
+    return PyInt_FromSsize_t(self->call_soon_limit);
+}
+
+
+static int
+Loop_call_soon_limit_set(Loop *self, PyObject* val, void* c)
+{
+    Py_ssize_t limit;
+
+    UNUSED_ARG(c);
+
+    if (val == NULL) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete attribute");
+        return -1;
+    }
+
+    limit = PyInt_AsSsize_t(val);
+    if (limit == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+
+    if (limit < 0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return -1;
+    }
+
+    self->call_soon_limit = limit;
+    return 0;
+}
+
+
 static PyMethodDef
 Loop_tp_methods[] = {
-    { "run", (PyCFunction)Loop_func_run, METH_NOARGS, "Run the event loop." },
+    { "run", (PyCFunction)Loop_func_run, METH_VARARGS|METH_KEYWORDS, "Run the event loop." },
+    { "stop", (PyCFunction)Loop_func_stop, METH_NOARGS, "Stop the event loop after the current iteration." },
     { "run_once", (PyCFunction)Loop_func_run_once, METH_NOARGS, "Run a single event loop iteration, waiting for events if necessary." },
-    { "now", (PyCFunction)Loop_func_now, METH_NOARGS, "Return event loop time, expressed in nanoseconds." },
+    { "process_events", (PyCFunction)Loop_func_process_events, METH_NOARGS, "Run a single event loop iteration without waiting for events." },
+    { "now", (PyCFunction)Loop_func_now, METH_NOARGS, "Return event loop time, expressed in milliseconds." },
+    { "now_ns", (PyCFunction)Loop_func_now_ns, METH_NOARGS, "Return event loop time, expressed in nanoseconds." },
     { "update_time", (PyCFunction)Loop_func_update_time, METH_NOARGS, "Update event loop's notion of time by querying the kernel." },
+    { "call_soon", (PyCFunction)Loop_func_call_soon, METH_VARARGS, "Call a function in the next loop iteration." },
+    { "call_soon_threadsafe", (PyCFunction)Loop_func_call_soon_threadsafe, METH_VARARGS, "Call a function in the next loop iteration, can be called from any thread." },
+    { "call_later", (PyCFunction)Loop_func_call_later, METH_VARARGS, "Call a function after the given delay." },
+    { "call_at", (PyCFunction)Loop_func_call_at, METH_VARARGS, "Call a function at the given loop time." },
+    { "add_prepare_hook", (PyCFunction)Loop_func_add_prepare_hook, METH_VARARGS|METH_KEYWORDS, "Add a function to be called before polling for I/O." },
+    { "remove_prepare_hook", (PyCFunction)Loop_func_remove_prepare_hook, METH_O, "Remove a prepare hook." },
+    { "add_check_hook", (PyCFunction)Loop_func_add_check_hook, METH_VARARGS|METH_KEYWORDS, "Add a function to be called after polling for I/O." },
+    { "remove_check_hook", (PyCFunction)Loop_func_remove_check_hook, METH_O, "Remove a check hook." },
+    { "add_idle_hook", (PyCFunction)Loop_func_add_idle_hook, METH_VARARGS|METH_KEYWORDS, "Add a function to be called once per loop iteration, without blocking for I/O." },
+    { "remove_idle_hook", (PyCFunction)Loop_func_remove_idle_hook, METH_O, "Remove an idle hook." },
     { "walk", (PyCFunction)Loop_func_walk, METH_VARARGS, "Walk all handles in the loop." },
+    { "enable_metrics", (PyCFunction)Loop_func_enable_metrics, METH_VARARGS | METH_KEYWORDS, "Enable or disable runtime metrics collection." },
+    { "get_metrics", (PyCFunction)Loop_func_get_metrics, METH_NOARGS, "Return a snapshot of the runtime metrics." },
+    { "get_histograms", (PyCFunction)Loop_func_get_histograms, METH_NOARGS, "Return a snapshot of the callback latency histograms." },
+    { "reset_metrics", (PyCFunction)Loop_func_reset_metrics, METH_NOARGS, "Reset the runtime metrics." },
+    { "set_slow_callback_threshold", (PyCFunction)Loop_func_set_slow_callback_threshold, METH_VARARGS, "Call a handler for every callback which takes longer than the given threshold." },
+    { "get_tcp_info", (PyCFunction)Loop_func_get_tcp_info, METH_NOARGS, "Get kernel statistics (TCP_INFO) for all TCP handles in the loop." },
     { "default_loop", (PyCFunction)Loop_func_default_loop, METH_CLASS|METH_NOARGS, "Instantiate the default loop." },
+    { "current", (PyCFunction)Loop_func_current, METH_CLASS|METH_NOARGS, "Return the loop running in the current thread, or the default loop." },
     { NULL }
 };
 
@@ -273,7 +751,11 @@ Loop_tp_methods[] = {
 static PyGetSetDef Loop_tp_getsets[] = {
     {"__dict__", (getter)Loop_dict_get, (setter)Loop_dict_set, NULL},
     {"default", (getter)Loop_default_get, NULL, "Is this the default loop?", NULL},
+    {"backend_fd", (getter)Loop_backend_fd_get, NULL, "File descriptor the loop polls for I/O, -1 if there is none.", NULL},
+    {"backend_timeout", (getter)Loop_backend_timeout_get, NULL, "Time the loop would block for when polling for I/O, None if it would block until there are events.", NULL},
     {"excepthook", (getter)Loop_excepthook_get, (setter)Loop_excepthook_set, "Loop uncaught exception handler", NULL},
+    {"slack", (getter)Loop_slack_get, (setter)Loop_slack_set, "Time calls scheduled with call_later can be delayed in order to run them together.", NULL},
+    {"call_soon_limit", (getter)Loop_call_soon_limit_get, (setter)Loop_call_soon_limit_set, "Maximum number of calls scheduled with call_soon run in a loop iteration.", NULL},
     {NULL}
 };
 
@@ -0,0 +1,372 @@
+
+/*
+ * LoopGroup: runs a number of loops, each one in its own thread. Threads keep running
+ * their loop (even if there are no active handles) until the group is stopped, calls
+ * are handed to them with Loop.call_soon_threadsafe.
+ */
+
+static void
+loop_group_thread_func(void *arg)
+{
+    PyGILState_STATE gstate;
+    loop_group_thread_t *thread = (loop_group_thread_t *)arg;
+    LoopGroup *group = thread->group;
+    Loop *loop = thread->loop;
+
+    gstate = PyGILState_Ensure();
+
+    current_loop = loop;
+    /* keep the loop alive, calls can be scheduled at any time */
+    uv_ref((uv_handle_t *)&loop->threadsafe_async);
+
+    Py_BEGIN_ALLOW_THREADS
+    while (!group->stopping) {
+        uv_run_once(loop->uv_loop);
+    }
+    Py_END_ALLOW_THREADS
+
+    uv_unref((uv_handle_t *)&loop->threadsafe_async);
+    current_loop = NULL;
+
+    if (PyErr_Occurred()) {
+        handle_uncaught_exception(loop);
+    }
+
+    /* the reference was taken by LoopGroup.start */
+    Py_DECREF(group);
+    PyGILState_Release(gstate);
+}
+
+
+/* stop and join the first count threads, must be called with the GIL held */
+static void
+loop_group_join(LoopGroup *self, Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    self->stopping = 1;
+    for (i = 0; i < count; i++) {
+        uv_async_send(&self->threads[i].loop->threadsafe_async);
+    }
+    /* threads need the GIL in order to finish */
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < count; i++) {
+        uv_thread_join(&self->threads[i].thread);
+    }
+    Py_END_ALLOW_THREADS
+    self->stopping = 0;
+}
+
+
+static PyObject *
+LoopGroup_func_start(LoopGroup *self)
+{
+    Py_ssize_t i;
+    loop_group_thread_t *thread;
+#ifdef PYUV_HAVE_CPU_AFFINITY
+    int r;
+    cpu_set_t cpus;
+#endif
+
+    if (self->running) {
+        PyErr_SetString(PyExc_RuntimeError, "LoopGroup is already running");
+        return NULL;
+    }
+
+    for (i = 0; i < self->count; i++) {
+        thread = &self->threads[i];
+        Py_INCREF(self);
+        if (uv_thread_create(&thread->thread, loop_group_thread_func, thread) != 0) {
+            Py_DECREF(self);
+            loop_group_join(self, i);
+            PyErr_SetString(PyExc_RuntimeError, "could not start loop thread");
+            return NULL;
+        }
+#ifdef PYUV_HAVE_CPU_AFFINITY
+        if (thread->cpu != -1) {
+            CPU_ZERO(&cpus);
+            CPU_SET(thread->cpu, &cpus);
+            r = pthread_setaffinity_np(thread->thread, sizeof(cpus), &cpus);
+            if (r != 0) {
+                loop_group_join(self, i + 1);
+                errno = r;
+                PyErr_SetFromErrno(PyExc_OSError);
+                return NULL;
+            }
+        }
+#endif
+    }
+
+    self->running = True;
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+LoopGroup_func_stop(LoopGroup *self)
+{
+    Py_ssize_t i;
+
+    if (!self->running) {
+        Py_RETURN_NONE;
+    }
+
+    for (i = 0; i < self->count; i++) {
+        if (current_loop == self->threads[i].loop) {
+            PyErr_SetString(PyExc_RuntimeError, "LoopGroup can't be stopped from one of its threads");
+            return NULL;
+        }
+    }
+
+    loop_group_join(self, self->count);
+    self->running = False;
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+LoopGroup_func_submit(LoopGroup *self, PyObject *args)
+{
+    Loop *loop;
+    PyObject *result;
+
+    if (!self->threads) {
+        PyErr_SetString(PyExc_RuntimeError, "LoopGroup is not initialized");
+        return NULL;
+    }
+
+    loop = self->threads[self->next].loop;
+    self->next = (self->next + 1) % self->count;
+
+    result = Loop_func_call_soon_threadsafe(loop, args);
+    if (!result) {
+        return NULL;
+    }
+    Py_DECREF(result);
+
+    Py_INCREF(loop);
+    return (PyObject *)loop;
+}
+
+
+static PyObject *
+LoopGroup_loops_get(LoopGroup *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    if (!self->loops) {
+        PyErr_SetString(PyExc_RuntimeError, "LoopGroup is not initialized");
+        return NULL;
+    }
+    Py_INCREF(self->loops);
+    return self->loops;
+}
+
+
+static PyObject *
+LoopGroup_running_get(LoopGroup *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyBool_FromLong((long)self->running);
+}
+
+
+static int
+LoopGroup_tp_init(LoopGroup *self, PyObject *args, PyObject *kwargs)
+{
+    int cpu;
+    Py_ssize_t i, count;
+    PyObject *loop, *affinity, *cpus;
+    loop_group_thread_t *threads;
+
+    static char *kwlist[] = {"count", "affinity", NULL};
+
+    affinity = Py_None;
+    cpus = NULL;
+
+    if (self->loops) {
+        PyErr_SetString(PyExc_RuntimeError, "Object already initialized");
+        return -1;
+    }
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|O:__init__", kwlist, &count, &affinity)) {
+        return -1;
+    }
+
+    if (count <= 0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value is required");
+        return -1;
+    }
+
+    if (affinity != Py_None) {
+#ifdef PYUV_HAVE_CPU_AFFINITY
+        cpus = PySequence_Fast(affinity, "affinity must be a sequence");
+        if (!cpus) {
+            return -1;
+        }
+        if (PySequence_Fast_GET_SIZE(cpus) != count) {
+            PyErr_SetString(PyExc_ValueError, "affinity must contain a CPU number for each loop");
+            goto error;
+        }
+#else
+        PyErr_SetString(PyExc_NotImplementedError, "CPU affinity is not supported on this platform");
+        return -1;
+#endif
+    }
+
+    threads = PyMem_Malloc(sizeof(loop_group_thread_t) * count);
+    if (!threads) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    self->threads = threads;
+
+    self->loops = PyTuple_New(count);
+    if (!self->loops) {
+        goto error;
+    }
+    self->count = 0;
+
+    for (i = 0; i < count; i++) {
+        cpu = -1;
+        if (cpus) {
+            cpu = (int)PyLong_AsLong(PySequence_Fast_GET_ITEM(cpus, i));
+            if (cpu == -1 && PyErr_Occurred()) {
+                goto error;
+            }
+#ifdef PYUV_HAVE_CPU_AFFINITY
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                PyErr_SetString(PyExc_ValueError, "invalid CPU number");
+                goto error;
+            }
+#endif
+        }
+
+        loop = PyObject_CallObject((PyObject *)&LoopType, NULL);
+        if (!loop) {
+            goto error;
+        }
+        PyTuple_SET_ITEM(self->loops, i, loop);
+
+        threads[i].loop = (Loop *)loop;
+        threads[i].group = self;
+        threads[i].cpu = cpu;
+        self->count++;
+    }
+
+    self->next = 0;
+    Py_XDECREF(cpus);
+    return 0;
+
+error:
+    Py_XDECREF(cpus);
+    Py_CLEAR(self->loops);
+    PyMem_Free(self->threads);
+    self->threads = NULL;
+    self->count = 0;
+    return -1;
+}
+
+
+static PyObject *
+LoopGroup_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    LoopGroup *self = (LoopGroup *)PyType_GenericNew(type, args, kwargs);
+    if (!self) {
+        return NULL;
+    }
+    self->loops = NULL;
+    self->threads = NULL;
+    self->count = 0;
+    self->next = 0;
+    self->running = False;
+    self->stopping = 0;
+    return (PyObject *)self;
+}
+
+
+static int
+LoopGroup_tp_traverse(LoopGroup *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->loops);
+    return 0;
+}
+
+
+static int
+LoopGroup_tp_clear(LoopGroup *self)
+{
+    Py_CLEAR(self->loops);
+    return 0;
+}
+
+
+static void
+LoopGroup_tp_dealloc(LoopGroup *self)
+{
+    /* running threads hold a reference to the group, so it can't be running here */
+    ASSERT(!self->running);
+    PyObject_GC_UnTrack(self);
+    LoopGroup_tp_clear(self);
+    PyMem_Free(self->threads);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+
+static PyMethodDef
+LoopGroup_tp_methods[] = {
+    { "start", (PyCFunction)LoopGroup_func_start, METH_NOARGS, "Start a thread for each loop in the group." },
+    { "stop", (PyCFunction)LoopGroup_func_stop, METH_NOARGS, "Stop all loops and wait for their threads to finish." },
+    { "submit", (PyCFunction)LoopGroup_func_submit, METH_VARARGS, "Call a function in the next loop of the group." },
+    { NULL }
+};
+
+
+static PyGetSetDef LoopGroup_tp_getsets[] = {
+    {"loops", (getter)LoopGroup_loops_get, NULL, "Loops in the group.", NULL},
+    {"running", (getter)LoopGroup_running_get, NULL, "Indicates if the loop threads are running.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject LoopGroupType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.LoopGroup",                                               /*tp_name*/
+    sizeof(LoopGroup),                                              /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)LoopGroup_tp_dealloc,                               /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)LoopGroup_tp_traverse,                            /*tp_traverse*/
+    (inquiry)LoopGroup_tp_clear,                                    /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    LoopGroup_tp_methods,                                           /*tp_methods*/
+    0,                                                              /*tp_members*/
+    LoopGroup_tp_getsets,                                           /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    (initproc)LoopGroup_tp_init,                                    /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    LoopGroup_tp_new,                                               /*tp_new*/
+};
+
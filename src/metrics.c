@@ -0,0 +1,507 @@
+
+/*
+ * Loop runtime metrics. Iterations and the time blocked in the kernel poll are
+ * measured with a prepare and a check handle, which run right before and right
+ * after polling for I/O. Callbacks are timed where they are called, the time spent
+ * in I/O callbacks (which run while polling) is not accounted as poll time.
+ *
+ * Optionally, callback durations and dispatch delays (the time between the loop
+ * starting to run a batch of ready events and a callback in the batch starting)
+ * are recorded in histograms, to look at tail latencies.
+ *
+ * The slow callback detector reports callbacks which take longer than a threshold.
+ * A watchdog thread, running its own loop, checks the callback being run at regular
+ * intervals and captures the Python stack of the loop thread when it's running late,
+ * so that the handler can tell where the time was spent.
+ */
+
+static const char *pyuv_metric_names[PYUV_METRIC_KINDS] = {
+    "timer",
+    "tcp_read",
+    "pipe_read",
+    "tty_read",
+    "udp_recv",
+    "fs",
+    "threadpool"
+};
+
+
+static void
+on_metrics_prepare(uv_prepare_t *handle, int status)
+{
+    loop_metrics_t *metrics = container_of(handle, loop_metrics_t, prepare_handle);
+
+    UNUSED_ARG(status);
+
+    metrics->iterations++;
+    metrics->poll_start = uv_hrtime();
+    metrics->poll_start_callback_time = metrics->callback_time;
+    /* I/O callbacks are dispatched as a batch when the poll returns */
+    metrics->dispatch_start = 0;
+}
+
+
+static void
+on_metrics_check(uv_check_t *handle, int status)
+{
+    uint64_t elapsed, callbacks;
+    loop_metrics_t *metrics = container_of(handle, loop_metrics_t, check_handle);
+
+    UNUSED_ARG(status);
+
+    /* timers which expired while polling are dispatched as a batch in the next iteration */
+    metrics->dispatch_start = 0;
+
+    if (metrics->poll_start == 0) {
+        return;
+    }
+    elapsed = uv_hrtime() - metrics->poll_start;
+    callbacks = metrics->callback_time - metrics->poll_start_callback_time;
+    if (elapsed > callbacks) {
+        metrics->poll_time += elapsed - callbacks;
+    }
+    metrics->poll_start = 0;
+}
+
+
+static void
+loop_metrics_reset(loop_metrics_t *metrics)
+{
+    metrics->iterations = 0;
+    metrics->poll_time = 0;
+    metrics->poll_start = 0;
+    metrics->poll_start_callback_time = 0;
+    metrics->callback_time = 0;
+    metrics->dispatch_start = 0;
+    memset(metrics->callbacks, 0, sizeof(metrics->callbacks));
+    if (metrics->histograms) {
+        memset(metrics->histograms, 0, sizeof(histogram_t) * PYUV_METRIC_KINDS * 2);
+    }
+}
+
+
+/* get the metrics structure of the loop, allocating it on first use */
+static loop_metrics_t *
+loop_metrics_get(Loop *loop)
+{
+    loop_metrics_t *metrics;
+
+    if (loop->metrics) {
+        return loop->metrics;
+    }
+
+    metrics = PyMem_Malloc(sizeof(loop_metrics_t));
+    if (!metrics) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    /* internal handles, they don't keep the loop alive and are not visible to Loop.walk */
+    uv_prepare_init(loop->uv_loop, &metrics->prepare_handle);
+    metrics->prepare_handle.data = NULL;
+    uv_unref((uv_handle_t *)&metrics->prepare_handle);
+    uv_check_init(loop->uv_loop, &metrics->check_handle);
+    metrics->check_handle.data = NULL;
+    uv_unref((uv_handle_t *)&metrics->check_handle);
+    metrics->enabled = False;
+    metrics->histograms = NULL;
+    metrics->histograms_enabled = False;
+    metrics->slow_callback_handler = NULL;
+    metrics->watchdog = NULL;
+    loop_metrics_reset(metrics);
+    loop->metrics = metrics;
+
+    return metrics;
+}
+
+
+static PyObject *
+Loop_func_enable_metrics(Loop *self, PyObject *args, PyObject *kwargs)
+{
+    loop_metrics_t *metrics;
+    PyObject *enable, *histograms;
+
+    static char *kwlist[] = {"enable", "histograms", NULL};
+
+    histograms = Py_False;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O!:enable_metrics", kwlist, &PyBool_Type, &enable, &PyBool_Type, &histograms)) {
+        return NULL;
+    }
+
+    if (!self->metrics && enable == Py_False) {
+        Py_RETURN_NONE;
+    }
+
+    metrics = loop_metrics_get(self);
+    if (!metrics) {
+        return NULL;
+    }
+    if (enable == Py_True && histograms == Py_True && !metrics->histograms) {
+        metrics->histograms = PyMem_Malloc(sizeof(histogram_t) * PYUV_METRIC_KINDS * 2);
+        if (!metrics->histograms) {
+            return PyErr_NoMemory();
+        }
+        memset(metrics->histograms, 0, sizeof(histogram_t) * PYUV_METRIC_KINDS * 2);
+    }
+
+    metrics->histograms_enabled = (enable == Py_True && histograms == Py_True);
+    if (enable == Py_True) {
+        metrics->enabled = True;
+        uv_prepare_start(&metrics->prepare_handle, on_metrics_prepare);
+        uv_check_start(&metrics->check_handle, on_metrics_check);
+    } else {
+        metrics->enabled = False;
+        uv_prepare_stop(&metrics->prepare_handle);
+        uv_check_stop(&metrics->check_handle);
+        metrics->poll_start = 0;
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Loop_func_get_metrics(Loop *self)
+{
+    int i;
+    loop_metrics_t *metrics;
+    PyObject *result, *callbacks, *item;
+
+    metrics = self->metrics;
+    if (!metrics) {
+        PyErr_SetString(PyExc_RuntimeError, "metrics are not enabled");
+        return NULL;
+    }
+
+    callbacks = PyDict_New();
+    if (!callbacks) {
+        return NULL;
+    }
+    for (i = 0; i < PYUV_METRIC_KINDS; i++) {
+        item = Py_BuildValue("(Kd)", (unsigned PY_LONG_LONG)metrics->callbacks[i].count, metrics->callbacks[i].time / 1e9);
+        if (!item || PyDict_SetItemString(callbacks, pyuv_metric_names[i], item) != 0) {
+            Py_XDECREF(item);
+            Py_DECREF(callbacks);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    result = Py_BuildValue("{s:K,s:d,s:d,s:N}",
+                           "iterations", (unsigned PY_LONG_LONG)metrics->iterations,
+                           "poll_time", metrics->poll_time / 1e9,
+                           "callback_time", metrics->callback_time / 1e9,
+                           "callbacks", callbacks);
+    return result;
+}
+
+
+static PyObject *
+Loop_func_get_histograms(Loop *self)
+{
+    int i;
+    loop_metrics_t *metrics;
+    PyObject *result, *item;
+
+    metrics = self->metrics;
+    if (!metrics || !metrics->histograms) {
+        PyErr_SetString(PyExc_RuntimeError, "histograms are not enabled");
+        return NULL;
+    }
+
+    result = PyDict_New();
+    if (!result) {
+        return NULL;
+    }
+    for (i = 0; i < PYUV_METRIC_KINDS; i++) {
+        item = Py_BuildValue("(NN)", Histogram_from_histogram(&metrics->histograms[i]),
+                                     Histogram_from_histogram(&metrics->histograms[PYUV_METRIC_KINDS + i]));
+        if (!item || PyDict_SetItemString(result, pyuv_metric_names[i], item) != 0) {
+            Py_XDECREF(item);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+    return result;
+}
+
+
+static void
+on_watchdog_timer(uv_timer_t *handle, int status)
+{
+    PyGILState_STATE gstate;
+    uint64_t start, seq;
+    PyObject *frames, *frame, *ident, *traceback, *stack;
+    slow_callback_watchdog_t *watchdog = container_of(handle, slow_callback_watchdog_t, timer_handle);
+
+    UNUSED_ARG(status);
+
+    /* unlocked peek, it's checked again with the GIL held */
+    start = watchdog->start;
+    seq = watchdog->seq;
+    if (start == 0 || uv_hrtime() - start < watchdog->threshold || watchdog->stack_seq == seq) {
+        return;
+    }
+
+    gstate = PyGILState_Ensure();
+
+    /* the loop thread can only update the callback being run while holding the GIL */
+    if (watchdog->start != start || watchdog->seq != seq) {
+        goto end;
+    }
+
+    stack = NULL;
+    frames = PyObject_CallObject(PySys_GetObject("_current_frames"), NULL);
+    ident = PyLong_FromUnsignedLong(watchdog->thread_ident);
+    traceback = PyImport_ImportModule("traceback");
+    if (frames && ident && traceback) {
+        frame = PyDict_GetItem(frames, ident);
+        if (frame) {
+            stack = PyObject_CallMethod(traceback, "extract_stack", "O", frame);
+        }
+    }
+    Py_XDECREF(frames);
+    Py_XDECREF(ident);
+    Py_XDECREF(traceback);
+
+    if (stack) {
+        Py_XDECREF(watchdog->stack);
+        watchdog->stack = stack;
+        watchdog->stack_seq = seq;
+    } else {
+        PyErr_Clear();
+    }
+
+end:
+    PyGILState_Release(gstate);
+}
+
+
+/* check twice per threshold, so that stacks are captured while the callback is still running */
+static INLINE uint64_t
+watchdog_interval(uint64_t threshold)
+{
+    uint64_t interval = threshold / 2000000;
+    return interval > 0 ? interval : 1;
+}
+
+
+static void
+on_watchdog_async(uv_async_t *handle, int status)
+{
+    uint64_t interval;
+    slow_callback_watchdog_t *watchdog = container_of(handle, slow_callback_watchdog_t, async_handle);
+
+    UNUSED_ARG(status);
+
+    if (watchdog->stopping) {
+        uv_close((uv_handle_t *)&watchdog->timer_handle, NULL);
+        uv_close((uv_handle_t *)&watchdog->async_handle, NULL);
+        return;
+    }
+
+    /* the threshold was changed, the timer can only be restarted from this thread */
+    interval = watchdog_interval(watchdog->threshold);
+    uv_timer_start(&watchdog->timer_handle, on_watchdog_timer, interval, interval);
+}
+
+
+static void
+watchdog_thread_func(void *arg)
+{
+    slow_callback_watchdog_t *watchdog = (slow_callback_watchdog_t *)arg;
+    uv_run(watchdog->uv_loop);
+}
+
+
+/* start a thread which runs its own loop and checks periodically if a callback is taking too long */
+static slow_callback_watchdog_t *
+slow_callback_watchdog_new(uint64_t threshold)
+{
+    uint64_t interval;
+    slow_callback_watchdog_t *watchdog;
+
+    watchdog = PyMem_Malloc(sizeof(slow_callback_watchdog_t));
+    if (!watchdog) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    watchdog->uv_loop = uv_loop_new();
+    if (!watchdog->uv_loop) {
+        PyMem_Free(watchdog);
+        PyErr_SetString(PyExc_RuntimeError, "could not create watchdog loop");
+        return NULL;
+    }
+
+    watchdog->stopping = False;
+    watchdog->threshold = threshold;
+    watchdog->thread_ident = 0;
+    watchdog->start = 0;
+    watchdog->seq = 0;
+    watchdog->stack = NULL;
+    watchdog->stack_seq = 0;
+
+    interval = watchdog_interval(threshold);
+    uv_timer_init(watchdog->uv_loop, &watchdog->timer_handle);
+    uv_timer_start(&watchdog->timer_handle, on_watchdog_timer, interval, interval);
+    uv_async_init(watchdog->uv_loop, &watchdog->async_handle, on_watchdog_async);
+
+    if (uv_thread_create(&watchdog->thread, watchdog_thread_func, watchdog) != 0) {
+        uv_loop_delete(watchdog->uv_loop);
+        PyMem_Free(watchdog);
+        PyErr_SetString(PyExc_RuntimeError, "could not start watchdog thread");
+        return NULL;
+    }
+
+    return watchdog;
+}
+
+
+/* stop the watchdog thread and free it, must be called with the GIL held */
+static void
+slow_callback_watchdog_destroy(slow_callback_watchdog_t *watchdog)
+{
+    watchdog->stopping = True;
+    uv_async_send(&watchdog->async_handle);
+    /* the thread could be waiting for the GIL */
+    Py_BEGIN_ALLOW_THREADS
+    uv_thread_join(&watchdog->thread);
+    Py_END_ALLOW_THREADS
+    uv_loop_delete(watchdog->uv_loop);
+    Py_XDECREF(watchdog->stack);
+    PyMem_Free(watchdog);
+}
+
+
+/* called after a callback which took longer than the threshold, the exception it raised (if any) is preserved */
+static void
+pyuv_metrics_slow_callback(Loop *loop, PyObject *handle, PyObject *callback, uint64_t elapsed)
+{
+    PyObject *type, *value, *tb, *handler, *stack, *result;
+    slow_callback_watchdog_t *watchdog = loop->metrics->watchdog;
+
+    if (watchdog->stack && watchdog->stack_seq == watchdog->seq) {
+        stack = watchdog->stack;
+    } else {
+        Py_XDECREF(watchdog->stack);
+        stack = Py_None;
+        Py_INCREF(Py_None);
+    }
+    watchdog->stack = NULL;
+
+    handler = loop->metrics->slow_callback_handler;
+    if (!handler) {
+        Py_DECREF(stack);
+        return;
+    }
+    Py_INCREF(handler);
+    Py_INCREF(loop);
+
+    PyErr_Fetch(&type, &value, &tb);
+    result = PyObject_CallFunction(handler, "OOdO", handle, callback ? callback : Py_None, elapsed / 1e9, stack);
+    if (result == NULL) {
+        handle_uncaught_exception(loop);
+    }
+    Py_XDECREF(result);
+    PyErr_Restore(type, value, tb);
+
+    Py_DECREF(stack);
+    Py_DECREF(handler);
+    Py_DECREF(loop);
+}
+
+
+static PyObject *
+Loop_func_set_slow_callback_threshold(Loop *self, PyObject *args)
+{
+    double threshold;
+    loop_metrics_t *metrics;
+    slow_callback_watchdog_t *watchdog;
+    PyObject *tmp, *handler;
+
+    handler = Py_None;
+
+    if (!PyArg_ParseTuple(args, "d|O:set_slow_callback_threshold", &threshold, &handler)) {
+        return NULL;
+    }
+
+    if (!(threshold >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    if (threshold * 1e9 >= (double)UINT64_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "threshold is too large");
+        return NULL;
+    }
+
+    if (threshold > 0.0 && !PyCallable_Check(handler)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (!self->metrics && threshold == 0.0) {
+        Py_RETURN_NONE;
+    }
+
+    metrics = loop_metrics_get(self);
+    if (!metrics) {
+        return NULL;
+    }
+
+    if (threshold == 0.0) {
+        watchdog = metrics->watchdog;
+        metrics->watchdog = NULL;
+        if (watchdog) {
+            slow_callback_watchdog_destroy(watchdog);
+        }
+        Py_CLEAR(metrics->slow_callback_handler);
+        Py_RETURN_NONE;
+    }
+
+    if (metrics->watchdog) {
+        if (metrics->watchdog->threshold != (uint64_t)(threshold * 1e9)) {
+            /* the watchdog thread reads it without the GIL, and restarts its timer when woken up */
+            metrics->watchdog->threshold = (uint64_t)(threshold * 1e9);
+            uv_async_send(&metrics->watchdog->async_handle);
+        }
+    } else {
+        metrics->watchdog = slow_callback_watchdog_new((uint64_t)(threshold * 1e9));
+        if (!metrics->watchdog) {
+            return NULL;
+        }
+    }
+
+    tmp = metrics->slow_callback_handler;
+    Py_INCREF(handler);
+    metrics->slow_callback_handler = handler;
+    Py_XDECREF(tmp);
+
+    Py_RETURN_NONE;
+}
+
+
+/* free the metrics structure, the loop it was running on has already been deleted */
+static void
+loop_metrics_destroy(loop_metrics_t *metrics)
+{
+    if (metrics->watchdog) {
+        slow_callback_watchdog_destroy(metrics->watchdog);
+    }
+    Py_XDECREF(metrics->slow_callback_handler);
+    PyMem_Free(metrics->histograms);
+    PyMem_Free(metrics);
+}
+
+
+static PyObject *
+Loop_func_reset_metrics(Loop *self)
+{
+    if (self->metrics) {
+        loop_metrics_reset(self->metrics);
+    }
+    Py_RETURN_NONE;
+}
+
@@ -2,7 +2,7 @@
 static void
 on_pipe_connection(uv_stream_t* server, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(server->loop);
     Pipe *self;
     PyObject *result, *py_errorno;
     ASSERT(server);
@@ -20,7 +20,7 @@ on_pipe_connection(uv_stream_t* server, int status)
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(self->on_new_connection_cb, self, py_errorno, NULL);
+    result = pyuv_call2(self->on_new_connection_cb, (PyObject *)self, py_errorno);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -35,7 +35,7 @@ on_pipe_connection(uv_stream_t* server, int status)
 static void
 on_pipe_client_connection(uv_connect_t *req, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
     Pipe *self;
     PyObject *callback, *result, *py_errorno;
     ASSERT(req);
@@ -55,7 +55,7 @@ on_pipe_client_connection(uv_connect_t *req, int status)
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, self, py_errorno, NULL);
+    result = pyuv_call2(callback, (PyObject *)self, py_errorno);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -70,13 +70,45 @@ on_pipe_client_connection(uv_connect_t *req, int status)
 }
 
 
+/* accept the handle pending on an IPC pipe into a new TCP or Pipe object */
+static PyObject *
+pyuv_pipe_accept_pending(Pipe *self, uv_handle_type pending)
+{
+    int r;
+    PyObject *client;
+
+    if (pending == UV_TCP) {
+        client = pyuv_call1((PyObject *)&TCPType, (PyObject *)((Handle *)self)->loop);
+    } else if (pending == UV_NAMED_PIPE) {
+        client = pyuv_call1((PyObject *)&PipeType, (PyObject *)((Handle *)self)->loop);
+    } else {
+        PyErr_SetString(PyExc_TypeError, "Only TCP and Pipe handles can be accepted");
+        return NULL;
+    }
+
+    if (!client) {
+        return NULL;
+    }
+
+    r = uv_accept((uv_stream_t *)UV_HANDLE(self), (uv_stream_t *)UV_HANDLE(client));
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_PipeError);
+        Py_DECREF(client);
+        return NULL;
+    }
+
+    return client;
+}
+
+
 static void
 on_pipe_read2(uv_pipe_t* handle, int nread, uv_buf_t buf, uv_handle_type pending)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     uv_err_t err;
     Stream *self;
     PyObject *result, *data, *py_errorno, *py_pending;
+    uint64_t start;
     ASSERT(handle);
 
     self = (Stream *)handle->data;
@@ -84,7 +116,23 @@ on_pipe_read2(uv_pipe_t* handle, int nread, uv_buf_t buf, uv_handle_type pending
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    py_pending = PyInt_FromLong((long)pending);
+    if (nread > 0 && self->on_timeout_cb) {
+        self->last_read = (uint64_t)uv_now(UV_HANDLE_LOOP(self));
+    }
+
+    if (!((Pipe *)self)->auto_accept) {
+        py_pending = PyInt_FromLong((long)pending);
+    } else if (pending != UV_UNKNOWN_HANDLE) {
+        py_pending = pyuv_pipe_accept_pending((Pipe *)self, pending);
+        if (!py_pending) {
+            handle_uncaught_exception(((Handle *)self)->loop);
+            py_pending = Py_None;
+            Py_INCREF(Py_None);
+        }
+    } else {
+        py_pending = Py_None;
+        Py_INCREF(Py_None);
+    }
 
     if (nread >= 0) {
         data = PyBytes_FromStringAndSize(buf.base, nread);
@@ -97,7 +145,9 @@ on_pipe_read2(uv_pipe_t* handle, int nread, uv_buf_t buf, uv_handle_type pending
         py_errorno = PyInt_FromLong((long)err.code);
     }
 
-    result = PyObject_CallFunctionObjArgs(self->on_read_cb, self, data, py_pending, py_errorno, NULL);
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call4(self->on_read_cb, (PyObject *)self, data, py_pending, py_errorno);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_PIPE_READ, start, (PyObject *)self, self->on_read_cb);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -111,6 +161,165 @@ on_pipe_read2(uv_pipe_t* handle, int nread, uv_buf_t buf, uv_handle_type pending
 }
 
 
+/*
+ * Passing several handles at once. libuv sends a single handle per write request (and
+ * its reader only takes one descriptor per message), so write_handles still queues one
+ * small write per handle, it only saves Python calls and reports back once all of them
+ * are done. On the receiving side handles are accepted as soon as they arrive and
+ * delivered in batches, once per loop iteration, from a check handle.
+ */
+
+struct pipe_handles_batch_s {
+    uv_check_t check_handle;    /* must be the first member, the memory is freed as a whole when the handle is closed */
+    Pipe *pipe;
+};
+
+typedef struct {
+    PyObject *callback;
+    PyObject *handles;
+    int pending;
+    int error;
+} pipe_write_handles_data_t;
+
+
+/* deliver the handles received so far */
+static void
+pipe_flush_pending_handles(Pipe *self, PyObject *py_errorno)
+{
+    PyObject *handles, *result;
+    uint64_t start;
+
+    handles = self->pending_handles;
+    self->pending_handles = PyList_New(0);
+    if (!self->pending_handles) {
+        self->pending_handles = handles;
+        handle_uncaught_exception(((Handle *)self)->loop);
+        return;
+    }
+
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call3(((Stream *)self)->on_read_cb, (PyObject *)self, handles, py_errorno);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_PIPE_READ, start, (PyObject *)self, ((Stream *)self)->on_read_cb);
+    if (result == NULL) {
+        handle_uncaught_exception(((Handle *)self)->loop);
+    }
+    Py_XDECREF(result);
+    Py_DECREF(handles);
+}
+
+
+static void
+on_pipe_handles_batch_check(uv_check_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    Pipe *self;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    self = ((pipe_handles_batch_t *)handle)->pipe;
+    ASSERT(self);
+
+    uv_check_stop(handle);
+    if (PyList_GET_SIZE(self->pending_handles) > 0) {
+        pipe_flush_pending_handles(self, Py_None);
+    }
+
+    /* reference was taken when the check handle was started */
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+static void
+on_pipe_read_handles(uv_pipe_t* handle, int nread, uv_buf_t buf, uv_handle_type pending)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    uv_err_t err;
+    Pipe *self;
+    PyObject *client, *py_errorno;
+
+    ASSERT(handle);
+    UNUSED_ARG(buf);
+
+    self = (Pipe *)handle->data;
+    ASSERT(self);
+    /* Object could go out of scope in the callback, increase refcount to avoid it */
+    Py_INCREF(self);
+
+    if (nread < 0) {
+        err = uv_last_error(UV_HANDLE_LOOP(self));
+        py_errorno = PyInt_FromLong((long)err.code);
+        pipe_flush_pending_handles(self, py_errorno);
+        Py_XDECREF(py_errorno);
+    } else if (pending != UV_UNKNOWN_HANDLE) {
+        client = pyuv_pipe_accept_pending(self, pending);
+        if (client == NULL) {
+            handle_uncaught_exception(((Handle *)self)->loop);
+        } else {
+            if (PyList_Append(self->pending_handles, client) != 0) {
+                handle_uncaught_exception(((Handle *)self)->loop);
+            }
+            Py_DECREF(client);
+            if (!uv_is_active((uv_handle_t *)&self->handles_batch->check_handle)) {
+                uv_check_start(&self->handles_batch->check_handle, on_pipe_handles_batch_check);
+                /* keep the pipe alive until the batch is delivered */
+                Py_INCREF(self);
+            }
+        }
+    }
+
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+static void
+on_pipe_write_handles(uv_write_t* req, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
+    pipe_write_handles_data_t *req_data;
+    Pipe *self;
+    PyObject *result, *py_errorno;
+
+    ASSERT(req);
+
+    req_data = (pipe_write_handles_data_t *)req->data;
+    self = (Pipe *)req->handle->data;
+    ASSERT(self);
+
+    if (status < 0 && req_data->error == 0) {
+        req_data->error = uv_last_error(UV_HANDLE_LOOP(self)).code;
+    }
+    PyMem_Free(req);
+
+    if (--req_data->pending == 0) {
+        /* Object could go out of scope in the callback, increase refcount to avoid it */
+        Py_INCREF(self);
+        if (req_data->callback != Py_None) {
+            if (req_data->error != 0) {
+                py_errorno = PyInt_FromLong((long)req_data->error);
+            } else {
+                py_errorno = Py_None;
+                Py_INCREF(Py_None);
+            }
+            result = pyuv_call2(req_data->callback, (PyObject *)self, py_errorno);
+            if (result == NULL) {
+                handle_uncaught_exception(((Handle *)self)->loop);
+            }
+            Py_XDECREF(result);
+            Py_XDECREF(py_errorno);
+        }
+        Py_DECREF(req_data->callback);
+        Py_DECREF(req_data->handles);
+        PyMem_Free(req_data);
+        Py_DECREF(self);
+    }
+
+    PyGILState_Release(gstate);
+}
+
+
 static PyObject *
 Pipe_func_bind(Pipe *self, PyObject *args)
 {
@@ -280,13 +489,14 @@ static PyObject *
 Pipe_func_start_read2(Pipe *self, PyObject *args)
 {
     int r;
-    PyObject *tmp, *callback;
+    PyObject *tmp, *callback, *auto_accept;
 
     tmp = NULL;
+    auto_accept = Py_False;
 
     RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
 
-    if (!PyArg_ParseTuple(args, "O:start_read2", &callback)) {
+    if (!PyArg_ParseTuple(args, "O|O!:start_read2", &callback, &PyBool_Type, &auto_accept)) {
         return NULL;
     }
 
@@ -301,6 +511,8 @@ Pipe_func_start_read2(Pipe *self, PyObject *args)
         return NULL;
     }
 
+    self->auto_accept = (auto_accept == Py_True) ? True : False;
+
     tmp = ((Stream *)self)->on_read_cb;
     Py_INCREF(callback);
     ((Stream *)self)->on_read_cb = callback;
@@ -339,6 +551,203 @@ Pipe_func_write2(Pipe *self, PyObject *args)
 }
 
 
+static PyObject *
+Pipe_func_start_read_handles(Pipe *self, PyObject *args)
+{
+    int r;
+    pipe_handles_batch_t *batch;
+    PyObject *tmp, *callback;
+
+    tmp = NULL;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    if (!PyArg_ParseTuple(args, "O:start_read_handles", &callback)) {
+        return NULL;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (!self->pending_handles) {
+        self->pending_handles = PyList_New(0);
+        if (!self->pending_handles) {
+            return NULL;
+        }
+    }
+
+    if (!self->handles_batch) {
+        batch = (pipe_handles_batch_t *)PyMem_Malloc(sizeof(pipe_handles_batch_t));
+        if (!batch) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        r = uv_check_init(UV_HANDLE_LOOP(self), &batch->check_handle);
+        if (r != 0) {
+            RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_PipeError);
+            PyMem_Free(batch);
+            return NULL;
+        }
+        /* internal handle, not visible to Loop.walk */
+        batch->check_handle.data = NULL;
+        batch->pipe = self;
+        self->handles_batch = batch;
+    }
+
+    r = uv_read2_start((uv_stream_t *)UV_HANDLE(self), (uv_alloc_cb)on_stream_alloc, (uv_read2_cb)on_pipe_read_handles);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_PipeError);
+        return NULL;
+    }
+
+    tmp = ((Stream *)self)->on_read_cb;
+    Py_INCREF(callback);
+    ((Stream *)self)->on_read_cb = callback;
+    Py_XDECREF(tmp);
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Pipe_func_write_handles(Pipe *self, PyObject *args)
+{
+    int r;
+    Py_ssize_t i, n;
+    uv_buf_t buf;
+    uv_write_t *wr;
+    pipe_write_handles_data_t *req_data;
+    PyObject *callback, *handles, *seq, *item;
+    /* every handle travels with a single byte of data */
+    static char payload[1] = {'\0'};
+
+    callback = Py_None;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    if (!PyArg_ParseTuple(args, "O|O:write_handles", &seq, &callback)) {
+        return NULL;
+    }
+
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable or None is required");
+        return NULL;
+    }
+
+    handles = PySequence_Tuple(seq);
+    if (!handles) {
+        return NULL;
+    }
+
+    n = PyTuple_GET_SIZE(handles);
+    if (n == 0) {
+        PyErr_SetString(PyExc_ValueError, "Sequence is empty");
+        Py_DECREF(handles);
+        return NULL;
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PyTuple_GET_ITEM(handles, i);
+        if (!PyObject_TypeCheck(item, &StreamType) || UV_HANDLE_CLOSED(item) || (UV_HANDLE(item)->type != UV_TCP && UV_HANDLE(item)->type != UV_NAMED_PIPE)) {
+            PyErr_SetString(PyExc_TypeError, "Only open TCP and Pipe objects are supported for write_handles");
+            Py_DECREF(handles);
+            return NULL;
+        }
+    }
+
+    req_data = (pipe_write_handles_data_t *)PyMem_Malloc(sizeof(pipe_write_handles_data_t));
+    if (!req_data) {
+        Py_DECREF(handles);
+        return PyErr_NoMemory();
+    }
+
+    Py_INCREF(callback);
+    req_data->callback = callback;
+    req_data->handles = handles;
+    req_data->pending = 0;
+    req_data->error = 0;
+
+    buf = uv_buf_init(payload, sizeof(payload));
+
+    for (i = 0; i < n; i++) {
+        wr = (uv_write_t *)PyMem_Malloc(sizeof(uv_write_t));
+        if (!wr) {
+            PyErr_NoMemory();
+            break;
+        }
+        wr->data = (void *)req_data;
+        r = uv_write2(wr, (uv_stream_t *)UV_HANDLE(self), &buf, 1, (uv_stream_t *)UV_HANDLE(PyTuple_GET_ITEM(handles, i)), on_pipe_write_handles);
+        if (r != 0) {
+            RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_PipeError);
+            PyMem_Free(wr);
+            break;
+        }
+        req_data->pending++;
+    }
+
+    if (req_data->pending == 0) {
+        Py_DECREF(callback);
+        Py_DECREF(handles);
+        PyMem_Free(req_data);
+        return NULL;
+    }
+
+    if (i < n) {
+        /* some handles were queued, the callback will report the error */
+        req_data->error = uv_last_error(UV_HANDLE_LOOP(self)).code;
+        if (req_data->error == 0) {
+            req_data->error = UV_ENOMEM;
+        }
+        PyErr_Clear();
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+/* close the handles which were accepted but not delivered yet */
+static void
+pipe_close_pending_handles(Pipe *self)
+{
+    Py_ssize_t i;
+    PyObject *handles, *result;
+
+    handles = self->pending_handles;
+    if (!handles) {
+        return;
+    }
+    self->pending_handles = NULL;
+
+    for (i = 0; i < PyList_GET_SIZE(handles); i++) {
+        result = PyObject_CallMethod(PyList_GET_ITEM(handles, i), "close", NULL);
+        if (result == NULL) {
+            handle_uncaught_exception(((Handle *)self)->loop);
+        }
+        Py_XDECREF(result);
+    }
+    Py_DECREF(handles);
+}
+
+
+static PyObject *
+Pipe_func_close(Pipe *self, PyObject *args)
+{
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+    pipe_close_pending_handles(self);
+    if (self->handles_batch) {
+        if (uv_is_active((uv_handle_t *)&self->handles_batch->check_handle)) {
+            /* release the reference taken when the batch was started */
+            Py_DECREF(self);
+        }
+        uv_close((uv_handle_t *)&self->handles_batch->check_handle, on_handle_dealloc_close);
+        self->handles_batch = NULL;
+    }
+    return Stream_func_close((Stream *)self, args);
+}
+
+
 static int
 Pipe_tp_init(Pipe *self, PyObject *args, PyObject *kwargs)
 {
@@ -364,12 +773,7 @@ Pipe_tp_init(Pipe *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_pipe = PyMem_Malloc(sizeof(uv_pipe_t));
-    if (!uv_pipe) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_pipe = &self->pipe_h;
 
     r = uv_pipe_init(UV_HANDLE_LOOP(self), uv_pipe, (ipc == Py_True) ? 1 : 0);
     if (r != 0) {
@@ -395,10 +799,22 @@ Pipe_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 }
 
 
+static void
+Pipe_tp_dealloc(Pipe *self)
+{
+    if (self->handles_batch) {
+        uv_close((uv_handle_t *)&self->handles_batch->check_handle, on_handle_dealloc_close);
+        self->handles_batch = NULL;
+    }
+    StreamType.tp_dealloc((PyObject *)self);
+}
+
+
 static int
 Pipe_tp_traverse(Pipe *self, visitproc visit, void *arg)
 {
     Py_VISIT(self->on_new_connection_cb);
+    Py_VISIT(self->pending_handles);
     StreamType.tp_traverse((PyObject *)self, visit, arg);
     return 0;
 }
@@ -408,6 +824,7 @@ static int
 Pipe_tp_clear(Pipe *self)
 {
     Py_CLEAR(self->on_new_connection_cb);
+    Py_CLEAR(self->pending_handles);
     StreamType.tp_clear((PyObject *)self);
     return 0;
 }
@@ -423,6 +840,9 @@ Pipe_tp_methods[] = {
     { "pending_instances", (PyCFunction)Pipe_func_pending_instances, METH_VARARGS, "Set the number of pending pipe instance handles when the pipe server is waiting for connections." },
     { "start_read2", (PyCFunction)Pipe_func_start_read2, METH_VARARGS, "Extended read methods for receiving handles over a pipe. The pipe must be initialized with ipc set to True." },
     { "write2", (PyCFunction)Pipe_func_write2, METH_VARARGS, "Write data and send handle over a pipe." },
+    { "write_handles", (PyCFunction)Pipe_func_write_handles, METH_VARARGS, "Send several handles over a pipe, one per message." },
+    { "start_read_handles", (PyCFunction)Pipe_func_start_read_handles, METH_VARARGS, "Start receiving batches of already accepted handles over a pipe. The pipe must be initialized with ipc set to True." },
+    { "close", (PyCFunction)Pipe_func_close, METH_VARARGS, "Close the pipe." },
     { NULL }
 };
 
@@ -432,7 +852,7 @@ static PyTypeObject PipeType = {
     "pyuv.Pipe",                                                   /*tp_name*/
     sizeof(Pipe),                                                  /*tp_basicsize*/
     0,                                                             /*tp_itemsize*/
-    0,                                                             /*tp_dealloc*/
+    (destructor)Pipe_tp_dealloc,                                   /*tp_dealloc*/
     0,                                                             /*tp_print*/
     0,                                                             /*tp_getattr*/
     0,                                                             /*tp_setattr*/
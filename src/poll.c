@@ -2,7 +2,7 @@
 static void
 on_poll_callback(uv_poll_t *handle, int status, int events)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     uv_err_t err;
     Poll *self;
     PyObject *result, *py_events, *py_errorno;
@@ -25,7 +25,7 @@ on_poll_callback(uv_poll_t *handle, int status, int events)
         py_errorno = PyInt_FromLong((long)err.code);
     }
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, py_events, py_errorno,NULL);
+    result = pyuv_call3(self->callback, (PyObject *)self, py_events, py_errorno);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -117,12 +117,7 @@ Poll_tp_init(Poll *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_poll = PyMem_Malloc(sizeof(uv_poll_t));
-    if (!uv_poll) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_poll = &self->poll_h;
 
     r = uv_poll_init_socket(UV_HANDLE_LOOP(self), uv_poll, (uv_os_sock_t)fd);
     if (r != 0) {
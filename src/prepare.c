@@ -14,7 +14,7 @@ on_prepare_callback(uv_prepare_t *handle, int status)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, NULL);
+    result = pyuv_call1(self->callback, (PyObject *)self);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -103,12 +103,7 @@ Prepare_tp_init(Prepare *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_prepare = PyMem_Malloc(sizeof(uv_prepare_t));
-    if (!uv_prepare) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_prepare = &self->prepare_h;
 
     r = uv_prepare_init(UV_HANDLE_LOOP(self), uv_prepare);
     if (r != 0) {
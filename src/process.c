@@ -181,7 +181,7 @@ static PyTypeObject StdIOType = {
 static void
 on_process_exit(uv_process_t *process, int exit_status, int term_signal)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(process->loop);
     Process *self;
     PyObject *result, *py_exit_status, *py_term_signal;
 
@@ -196,7 +196,7 @@ on_process_exit(uv_process_t *process, int exit_status, int term_signal)
     py_term_signal = PyInt_FromLong(term_signal);
 
     if (self->on_exit_cb != Py_None) {
-        result = PyObject_CallFunctionObjArgs(self->on_exit_cb, self, py_exit_status, py_term_signal, NULL);
+        result = pyuv_call3(self->on_exit_cb, (PyObject *)self, py_exit_status, py_term_signal);
         if (result == NULL) {
             handle_uncaught_exception(((Handle *)self)->loop);
         }
@@ -388,19 +388,13 @@ Process_func_spawn(Process *self, PyObject *args, PyObject *kwargs)
     options.stdio = stdio_container;
     options.stdio_count = stdio_count;
 
-    uv_process = PyMem_Malloc(sizeof(uv_process_t));
-    if (!uv_process) {
-        PyErr_NoMemory();
-        ret = NULL;
-        goto cleanup;
-    }
+    uv_process = &self->process_h;
     uv_process->data = (void *)self;
     UV_HANDLE(self) = (uv_handle_t *)uv_process;
 
     r = uv_spawn(UV_HANDLE_LOOP(self), uv_process, options);
     if (r != 0) {
         RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_ProcessError);
-        PyMem_Free(uv_process);
         UV_HANDLE(self) = NULL;
         ret = NULL;
         goto cleanup;
@@ -3,9 +3,17 @@
 
 #include "errno.c"
 #include "error.c"
+#include "timerwheel.c"
+#include "calllater.c"
+#include "callsoon.c"
+#include "hooks.c"
+#include "histogram.c"
+#include "metrics.c"
 #include "loop.c"
+#include "loopgroup.c"
 #include "handle.c"
 #include "async.c"
+#include "channel.c"
 #include "timer.c"
 #include "prepare.c"
 #include "idle.c"
@@ -14,9 +22,11 @@
 #include "stream.c"
 #include "pipe.c"
 #include "tcp.c"
+#include "tcppool.c"
 #include "tty.c"
 #include "udp.c"
 #include "poll.c"
+#include "shmchannel.c"
 #include "fs.c"
 #include "threadpool.c"
 #include "process.c"
@@ -126,7 +136,9 @@ init_pyuv(void)
 
     /* Types */
     AsyncType.tp_base = &HandleType;
+    ChannelType.tp_base = &HandleType;
     TimerType.tp_base = &HandleType;
+    TimerWheelType.tp_base = &HandleType;
     PrepareType.tp_base = &HandleType;
     IdleType.tp_base = &HandleType;
     CheckType.tp_base = &HandleType;
@@ -134,6 +146,9 @@ init_pyuv(void)
     UDPType.tp_base = &HandleType;
     PollType.tp_base = &HandleType;
     ProcessType.tp_base = &HandleType;
+#ifdef PYUV_HAVE_SHM_CHANNEL
+    ShmChannelType.tp_base = &HandleType;
+#endif
 
     StreamType.tp_base = &HandleType;
     TCPType.tp_base = &StreamType;
@@ -141,22 +156,46 @@ init_pyuv(void)
     TTYType.tp_base = &StreamType;
 
     PyUVModule_AddType(pyuv, "Loop", &LoopType);
+    PyUVModule_AddType(pyuv, "LoopGroup", &LoopGroupType);
+    PyUVModule_AddType(pyuv, "ScheduledCall", &ScheduledCallType);
+    PyUVModule_AddType(pyuv, "Histogram", &HistogramType);
     PyUVModule_AddType(pyuv, "Async", &AsyncType);
+    PyUVModule_AddType(pyuv, "Channel", &ChannelType);
     PyUVModule_AddType(pyuv, "Timer", &TimerType);
+    PyUVModule_AddType(pyuv, "TimerWheel", &TimerWheelType);
+    PyUVModule_AddType(pyuv, "TimerWheelEntry", &TimerWheelEntryType);
     PyUVModule_AddType(pyuv, "Prepare", &PrepareType);
     PyUVModule_AddType(pyuv, "Idle", &IdleType);
     PyUVModule_AddType(pyuv, "Check", &CheckType);
     PyUVModule_AddType(pyuv, "Signal", &SignalType);
     PyUVModule_AddType(pyuv, "TCP", &TCPType);
+    PyUVModule_AddType(pyuv, "TCPPool", &TCPPoolType);
     PyUVModule_AddType(pyuv, "Pipe", &PipeType);
     PyUVModule_AddType(pyuv, "TTY", &TTYType);
     PyUVModule_AddType(pyuv, "UDP", &UDPType);
     PyUVModule_AddType(pyuv, "Poll", &PollType);
+#ifdef PYUV_HAVE_SHM_CHANNEL
+    PyUVModule_AddType(pyuv, "ShmChannel", &ShmChannelType);
+#endif
     PyUVModule_AddType(pyuv, "StdIO", &StdIOType);
     PyUVModule_AddType(pyuv, "Process", &ProcessType);
     PyUVModule_AddType(pyuv, "ThreadPool", &ThreadPoolType);
     PyUVModule_AddType(pyuv, "SignalChecker", &SignalCheckerType);
 
+    /* Internal types */
+    if (PyType_Ready(&TCPPoolHostType)) {
+        goto fail;
+    }
+
+    /* initialize PyStructSequence types */
+    if (TCPInfoResultType.tp_name == 0)
+        PyStructSequence_InitType(&TCPInfoResultType, &tcp_info_result_desc);
+
+    /* Loop.run modes */
+    PyModule_AddIntConstant(pyuv, "UV_RUN_DEFAULT", PYUV_RUN_DEFAULT);
+    PyModule_AddIntConstant(pyuv, "UV_RUN_ONCE", PYUV_RUN_ONCE);
+    PyModule_AddIntConstant(pyuv, "UV_RUN_NOWAIT", PYUV_RUN_NOWAIT);
+
     /* UDP constants */
     PyModule_AddIntMacro(pyuv, UV_JOIN_GROUP);
     PyModule_AddIntMacro(pyuv, UV_LEAVE_GROUP);
@@ -8,17 +8,57 @@
 #include "structmember.h"
 #include "structseq.h"
 #include "bytesobject.h"
+#include "pythread.h"
 
 /* Python3 */
 #if PY_MAJOR_VERSION >= 3
     #define PYUV_PYTHON3
     #define PyInt_FromSsize_t PyLong_FromSsize_t
+    #define PyInt_AsSsize_t PyLong_AsSsize_t
     #define PyInt_FromLong PyLong_FromLong
 #endif
 
+/* Fast calling conventions: METH_FASTCALL methods get their arguments as a C array and
+ * vectorcall lets callbacks be called without building an arguments tuple */
+#if PY_VERSION_HEX >= 0x03070000
+    #define PYUV_HAVE_FASTCALL
+    #define PYUV_METH_FASTCALL METH_FASTCALL
+    #define PYUV_METH_FASTCALL_KEYWORDS (METH_FASTCALL | METH_KEYWORDS)
+    #define PYUV_FASTCALL_PARAMS PyObject *const *args, Py_ssize_t nargs
+    #define PYUV_FASTCALL_KEYWORDS_PARAMS PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames
+    #define PYUV_UNPACK_ARGS(name, min, max, ...) pyuv_unpack_stack(args, nargs, name, min, max, __VA_ARGS__)
+#else
+    #define PYUV_METH_FASTCALL METH_VARARGS
+    #define PYUV_METH_FASTCALL_KEYWORDS (METH_VARARGS | METH_KEYWORDS)
+    #define PYUV_FASTCALL_PARAMS PyObject *args
+    #define PYUV_FASTCALL_KEYWORDS_PARAMS PyObject *args, PyObject *kwargs
+    #define PYUV_UNPACK_ARGS(name, min, max, ...) PyArg_UnpackTuple(args, name, min, max, __VA_ARGS__)
+#endif
+#if PY_VERSION_HEX >= 0x03090000
+    #define PYUV_HAVE_VECTORCALL
+#endif
+
 /* libuv */
 #include "uv.h"
 
+/* TCP_INFO is only available on Linux */
+#if defined(__linux__)
+    #include <netinet/tcp.h>
+    #ifdef TCP_INFO
+        #define PYUV_HAVE_TCP_INFO
+    #endif
+#endif
+
+/* ShmChannel needs POSIX shared memory and eventfd, only available on Linux */
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/eventfd.h>
+    #define PYUV_HAVE_SHM_CHANNEL
+#endif
+
 
 /* Custom types */
 typedef int Bool;
@@ -85,20 +125,261 @@ typedef int Bool;
     } while(0)                                                                      \
 
 
+#define container_of(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+
+/* thread local storage */
+#ifdef _MSC_VER
+    #define PYUV_THREAD_LOCAL __declspec(thread)
+#else
+    #define PYUV_THREAD_LOCAL __thread
+#endif
+
+/* CPU affinity for LoopGroup threads is only available on Linux */
+#if defined(__linux__)
+    #include <sched.h>
+    #include <pthread.h>
+    #define PYUV_HAVE_CPU_AFFINITY
+#endif
+
+/* size of the per loop buffer used for reading from streams and UDP handles */
+#define PYUV_READ_SLAB_SIZE 65536
+
+/* atomic pointer operations. CAS is a full barrier, XCHG is only an acquire barrier with GCC,
+ * which is enough for the way it's used: taking a whole list pushed by other threads with CAS */
+#ifdef _MSC_VER
+    #define PYUV_ATOMIC_CAS_PTR(ptr, oldval, newval) \
+        (InterlockedCompareExchangePointer((PVOID volatile *)(ptr), (PVOID)(newval), (PVOID)(oldval)) == (PVOID)(oldval))
+    #define PYUV_ATOMIC_XCHG_PTR(ptr, val) InterlockedExchangePointer((PVOID volatile *)(ptr), (PVOID)(val))
+#else
+    #define PYUV_ATOMIC_CAS_PTR(ptr, oldval, newval) __sync_bool_compare_and_swap((ptr), (oldval), (newval))
+    #define PYUV_ATOMIC_XCHG_PTR(ptr, val) __sync_lock_test_and_set((ptr), (val))
+#endif
+
+
+/* Hierarchical timer wheel (timerwheel.c) */
+
+#define TIMER_WHEEL_LEVELS 4
+
+typedef struct tw_entry_s tw_entry_t;
+typedef struct timer_wheel_s timer_wheel_t;
+
+/* expired entries are handed to the callback as a list headed by a sentinel entry */
+typedef void (*timer_wheel_cb)(timer_wheel_t *wheel, tw_entry_t *expired);
+
+struct tw_entry_s {
+    tw_entry_t *next;
+    tw_entry_t *prev;
+    uint64_t expires;
+};
+
+struct timer_wheel_s {
+    uv_timer_t timer_handle;    /* must be the first member */
+    tw_entry_t *slots;          /* TIMER_WHEEL_LEVELS * (1 << bits) list heads */
+    unsigned int bits;
+    uint64_t mask;
+    uint64_t base;              /* loop time of tick 0 */
+    uint64_t tick;              /* tick length in milliseconds */
+    uint64_t current;           /* last processed tick */
+    uint64_t scheduled;         /* tick the timer is going to fire at, 0 if stopped */
+    Py_ssize_t count;
+    timer_wheel_cb expire_cb;
+    void *data;
+};
+
+
+/* Queue of calls scheduled with Loop.call_later (calllater.c) */
+typedef struct {
+    uv_timer_t timer_handle;    /* must be the first member */
+    struct Loop_s *loop;
+    PyObject **heap;            /* ScheduledCall objects, ordered by expiration time */
+    Py_ssize_t len;
+    Py_ssize_t size;
+    uint64_t seq;
+    uint64_t armed;             /* expiration time the timer was started for */
+} call_queue_t;
+
+
+/* Ring buffer of calls scheduled with Loop.call_soon (callsoon.c) */
+typedef struct {
+    uv_idle_t idle_handle;      /* must be the first member */
+    struct Loop_s *loop;
+    PyObject **items;           /* (callback, args) pairs */
+    Py_ssize_t head;
+    Py_ssize_t len;
+    Py_ssize_t size;            /* capacity in pairs, always a power of 2 */
+} ready_queue_t;
+
+
+/* Prepare, check and idle hooks registered on a loop (hooks.c) */
+enum {
+    PYUV_HOOK_PREPARE = 0,
+    PYUV_HOOK_CHECK,
+    PYUV_HOOK_IDLE,
+    PYUV_HOOK_KINDS
+};
+
+typedef struct {
+    union {
+        uv_prepare_t prepare;
+        uv_check_t check;
+        uv_idle_t idle;
+    } handle;                   /* must be the first member */
+    struct Loop_s *loop;
+    int kind;
+    PyObject *hooks;            /* tuple of (priority, callback) tuples, replaced on every change */
+} loop_hooks_t;
+
+
+/* Calls scheduled from any thread with Loop.call_soon_threadsafe (callsoon.c) */
+typedef struct threadsafe_call_s {
+    struct threadsafe_call_s *next;
+    PyObject *callback;
+    PyObject *args;
+} threadsafe_call_t;
+
+
+/* Loop runtime metrics (metrics.c) */
+enum {
+    PYUV_METRIC_TIMER = 0,
+    PYUV_METRIC_TCP_READ,
+    PYUV_METRIC_PIPE_READ,
+    PYUV_METRIC_TTY_READ,
+    PYUV_METRIC_UDP_RECV,
+    PYUV_METRIC_FS,
+    PYUV_METRIC_THREADPOOL,
+    PYUV_METRIC_KINDS
+};
+
+typedef struct {
+    uint64_t count;
+    uint64_t time;              /* nanoseconds */
+} callback_stats_t;
+
+/* log-linear histogram of nanosecond values (histogram.c): values below 16 get their own
+ * bucket, every power of 2 above that is split in 16 linear sub-buckets (~6% precision) */
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+typedef struct {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+} histogram_t;
+
+/* thread which captures the Python stack of the loop thread while a callback is running slow */
+typedef struct {
+    uv_thread_t thread;
+    uv_loop_t *uv_loop;
+    uv_timer_t timer_handle;
+    uv_async_t async_handle;        /* wakes up the thread to stop it or to apply a new threshold */
+    volatile Bool stopping;
+    volatile uint64_t threshold;    /* nanoseconds */
+    unsigned long thread_ident;     /* Python thread running the loop */
+    volatile uint64_t start;        /* when the running callback started, 0 if none is */
+    volatile uint64_t seq;          /* incremented for each callback */
+    PyObject *stack;
+    uint64_t stack_seq;             /* callback the stack was captured for */
+} slow_callback_watchdog_t;
+
+typedef struct {
+    uv_prepare_t prepare_handle;
+    uv_check_t check_handle;
+    Bool enabled;
+    Bool histograms_enabled;
+    uint64_t iterations;
+    uint64_t poll_time;
+    uint64_t poll_start;
+    uint64_t poll_start_callback_time;
+    uint64_t callback_time;
+    uint64_t dispatch_start;    /* when the loop started running the current batch of callbacks */
+    callback_stats_t callbacks[PYUV_METRIC_KINDS];
+    histogram_t *histograms;    /* callback durations, followed by dispatch delays, per kind */
+    PyObject *slow_callback_handler;
+    slow_callback_watchdog_t *watchdog;
+} loop_metrics_t;
+
+
 /* Python types definitions */
 
 /* Loop */
-typedef struct {
+typedef struct Loop_s {
     PyObject_HEAD
     PyObject *excepthook_cb;
     PyObject *weakreflist;
     PyObject *dict;
     uv_loop_t *uv_loop;
     int is_default;
+    timer_wheel_t *stream_timeouts;
+    call_queue_t *call_queue;
+    uint64_t call_slack;
+    ready_queue_t *ready_queue;
+    Py_ssize_t call_soon_limit; /* max calls run per loop iteration, 0 means no limit */
+    uv_idle_t run_idle;         /* internal, keeps the loop from blocking in RUN_NOWAIT mode */
+    uv_timer_t run_timer;       /* internal, wakes up the loop when a run timeout expires */
+    volatile int stop;
+    loop_metrics_t *metrics;
+    uv_prepare_t gil_prepare;   /* internal, releases the GIL before polling when running with hold_gil */
+    uv_check_t gil_check;       /* internal, takes the GIL back after polling */
+    PyThreadState *gil_tstate;  /* saved thread state while the GIL is released for polling */
+    uv_async_t threadsafe_async;                    /* internal, wakes up the loop for calls scheduled from other threads */
+    threadsafe_call_t * volatile threadsafe_calls;  /* lock-free stack, newest call first */
+    char *read_slab;            /* buffer for stream and UDP reads, allocated with the loop */
+    loop_hooks_t *hooks[PYUV_HOOK_KINDS];
 } Loop;
 
+/* Loop.run modes */
+#define PYUV_RUN_DEFAULT 0
+#define PYUV_RUN_ONCE    1
+#define PYUV_RUN_NOWAIT  2
+
 static PyTypeObject LoopType;
 
+/* LoopGroup */
+typedef struct LoopGroup_s LoopGroup;
+
+typedef struct {
+    uv_thread_t thread;
+    Loop *loop;
+    LoopGroup *group;
+    int cpu;                    /* CPU the thread is bound to, -1 if none */
+} loop_group_thread_t;
+
+struct LoopGroup_s {
+    PyObject_HEAD
+    PyObject *loops;            /* tuple of Loop objects, one per thread */
+    loop_group_thread_t *threads;
+    Py_ssize_t count;
+    Py_ssize_t next;            /* loop the next submitted call goes to */
+    Bool running;
+    volatile int stopping;
+};
+
+static PyTypeObject LoopGroupType;
+
+/* Histogram */
+typedef struct {
+    PyObject_HEAD
+    histogram_t hist;
+} Histogram;
+
+static PyTypeObject HistogramType;
+
+/* ScheduledCall */
+typedef struct {
+    PyObject_HEAD
+    Loop *loop;
+    PyObject *callback;
+    PyObject *args;
+    uint64_t when;
+    uint64_t seq;
+    Py_ssize_t index;           /* position in the heap, -1 if not scheduled */
+    Bool cancelled;
+} ScheduledCall;
+
+static PyTypeObject ScheduledCallType;
+
 /* Handle */
 typedef struct {
     PyObject_HEAD
@@ -106,30 +387,77 @@ typedef struct {
     PyObject *dict;
     Loop *loop;
     PyObject *on_close_cb;
-    uv_handle_t *uv_handle;
+    uv_handle_t *uv_handle;     /* points to the handle stored in the subtype, NULL once closed */
+    Bool uv_handle_external;    /* uv_handle was allocated separately, it's freed when closed */
 } Handle;
 
 static PyTypeObject HandleType;
 
+/* deallocated objects kept for reuse, for handle types which are created and destroyed often (handle.c) */
+#define PYUV_DEFAULT_FREELIST_SIZE 64
+
+typedef struct {
+    PyTypeObject *type;
+    PyObject **items;
+    Py_ssize_t len;
+} handle_freelist_t;
+
 /* Async */
 typedef struct {
     Handle handle;
+    uv_async_t async_h;
     PyObject *callback;
 } Async;
 
 static PyTypeObject AsyncType;
 
+/* Channel */
+typedef struct channel_item_s {
+    struct channel_item_s *next;
+    PyObject *obj;
+} channel_item_t;
+
+typedef struct {
+    Handle handle;
+    uv_async_t async_h;
+    PyObject *callback;
+    channel_item_t * volatile head;     /* lock-free stack, newest item first */
+} Channel;
+
+static PyTypeObject ChannelType;
+
 /* Timer */
 typedef struct {
     Handle handle;
+    uv_timer_t timer_h;
     PyObject *callback;
+    uint64_t slack;
 } Timer;
 
 static PyTypeObject TimerType;
 
+/* TimerWheel */
+typedef struct {
+    Handle handle;
+    timer_wheel_t *wheel;
+    tw_entry_t *expired;
+} TimerWheel;
+
+static PyTypeObject TimerWheelType;
+
+typedef struct {
+    PyObject_HEAD
+    tw_entry_t entry;
+    TimerWheel *wheel;
+    PyObject *callback;
+} TimerWheelEntry;
+
+static PyTypeObject TimerWheelEntryType;
+
 /* Prepare */
 typedef struct {
     Handle handle;
+    uv_prepare_t prepare_h;
     PyObject *callback;
 } Prepare;
 
@@ -138,6 +466,7 @@ static PyTypeObject PrepareType;
 /* Idle */
 typedef struct {
     Handle handle;
+    uv_idle_t idle_h;
     PyObject *callback;
 } Idle;
 
@@ -146,6 +475,7 @@ static PyTypeObject IdleType;
 /* Check */
 typedef struct {
     Handle handle;
+    uv_check_t check_h;
     PyObject *callback;
 } Check;
 
@@ -154,6 +484,7 @@ static PyTypeObject CheckType;
 /* Signal */
 typedef struct {
     Handle handle;
+    uv_signal_t signal_h;
     PyObject *callback;
 } Signal;
 
@@ -165,6 +496,8 @@ typedef struct {
     Loop *loop;
     uv_prepare_t *prepare_handle;
     uv_check_t *check_handle;
+    uv_poll_t *poll_handle;     /* only used when a wakeup fd is given */
+    int fd;
 } SignalChecker;
 
 static PyTypeObject SignalCheckerType;
@@ -173,6 +506,12 @@ static PyTypeObject SignalCheckerType;
 typedef struct {
     Handle handle;
     PyObject *on_read_cb;
+    PyObject *on_timeout_cb;
+    tw_entry_t timeout_entry;
+    uint64_t read_idle;
+    uint64_t write_idle;
+    uint64_t last_read;
+    uint64_t last_write;
 } Stream;
 
 static PyTypeObject StreamType;
@@ -180,15 +519,49 @@ static PyTypeObject StreamType;
 /* TCP */
 typedef struct {
     Stream stream;
+    uv_tcp_t tcp_h;
     PyObject *on_new_connection_cb;
+    struct TCPPool_s *pool;
 } TCP;
 
 static PyTypeObject TCPType;
 
+/* TCPPool */
+typedef struct TCPPool_s {
+    PyObject_HEAD
+    Loop *loop;
+    PyObject *hosts;
+    PyObject *handles;
+    uv_timer_t *timer_handle;
+    unsigned int max_per_host;
+    double idle_timeout;
+    int64_t sweep_interval;
+    Py_ssize_t idle_count;
+    Bool closed;
+} TCPPool;
+
+static PyTypeObject TCPPoolType;
+
+/* TCPPool per host state */
+typedef struct {
+    PyObject_HEAD
+    PyObject *idle;
+    PyObject *waiters;
+    Py_ssize_t count;
+} TCPPoolHost;
+
+static PyTypeObject TCPPoolHostType;
+
 /* Pipe */
+typedef struct pipe_handles_batch_s pipe_handles_batch_t;
+
 typedef struct {
     Stream stream;
+    uv_pipe_t pipe_h;
     PyObject *on_new_connection_cb;
+    PyObject *pending_handles;
+    pipe_handles_batch_t *handles_batch;
+    Bool auto_accept;
 } Pipe;
 
 static PyTypeObject PipeType;
@@ -196,6 +569,7 @@ static PyTypeObject PipeType;
 /* TTY */
 typedef struct {
     Stream stream;
+    uv_tty_t tty_h;
 } TTY;
 
 static PyTypeObject TTYType;
@@ -203,14 +577,40 @@ static PyTypeObject TTYType;
 /* UDP */
 typedef struct {
     Handle handle;
+    uv_udp_t udp_h;
     PyObject *on_read_cb;
 } UDP;
 
 static PyTypeObject UDPType;
 
+/* ShmChannel */
+#ifdef PYUV_HAVE_SHM_CHANNEL
+typedef struct {
+    volatile uint64_t head;     /* written by the producer only */
+    char pad1[64 - sizeof(uint64_t)];
+    volatile uint64_t tail;     /* written by the consumer only */
+    char pad2[64 - sizeof(uint64_t)];
+    volatile uint64_t failed;   /* set by the consumer when it finds a corrupted message */
+} shm_channel_header_t;
+
+typedef struct {
+    Handle handle;
+    PyObject *callback;
+    shm_channel_header_t *header;
+    char *data;
+    size_t size;
+    size_t capacity;
+    int shm_fd;
+    int event_fd;
+} ShmChannel;
+
+static PyTypeObject ShmChannelType;
+#endif
+
 /* Poll */
 typedef struct {
     Handle handle;
+    uv_poll_t poll_h;
     PyObject *callback;
 } Poll;
 
@@ -228,6 +628,7 @@ static PyTypeObject StdIOType;
 
 typedef struct {
     Handle handle;
+    uv_process_t process_h;
     PyObject *on_exit_cb;
     PyObject *stdio;
 } Process;
@@ -237,6 +638,7 @@ static PyTypeObject ProcessType;
 /* FSEvent */
 typedef struct {
     Handle handle;
+    uv_fs_event_t fs_event_h;
     PyObject *callback;
 } FSEvent;
 
@@ -245,6 +647,7 @@ static PyTypeObject FSEventType;
 /* FSPoll */
 typedef struct {
     Handle handle;
+    uv_fs_poll_t fs_poll_h;
     PyObject *callback;
 } FSPoll;
 
@@ -261,6 +664,7 @@ static PyTypeObject ThreadPoolType;
 
 /* Exceptions */
 static PyObject* PyExc_AsyncError;
+static PyObject* PyExc_ChannelError;
 static PyObject* PyExc_CheckError;
 static PyObject* PyExc_FSError;
 static PyObject* PyExc_FSEventError;
@@ -273,9 +677,11 @@ static PyObject* PyExc_PollError;
 static PyObject* PyExc_PrepareError;
 static PyObject* PyExc_ProcessError;
 static PyObject* PyExc_SignalError;
+static PyObject* PyExc_ShmChannelError;
 static PyObject* PyExc_SignalCheckerError;
 static PyObject* PyExc_StreamError;
 static PyObject* PyExc_TCPError;
+static PyObject* PyExc_TCPPoolError;
 static PyObject* PyExc_ThreadPoolError;
 static PyObject* PyExc_TimerError;
 static PyObject* PyExc_TTYError;
@@ -392,6 +798,35 @@ static PyStructSequence_Desc cpu_info_times_result_desc = {
 };
 
 
+/* used by TCP.get_info and Loop.get_tcp_info */
+static PyTypeObject TCPInfoResultType;
+
+static PyStructSequence_Field tcp_info_result_fields[] = {
+    {"state",          "TCP connection state"},
+    {"ca_state",       "congestion avoidance state"},
+    {"retransmits",    "number of unrecovered RTO timeouts"},
+    {"rtt",            "smoothed round trip time, in microseconds"},
+    {"rttvar",         "round trip time variance, in microseconds"},
+    {"snd_cwnd",       "congestion window, in segments"},
+    {"snd_ssthresh",   "slow start threshold, in segments"},
+    {"snd_mss",        "sender maximum segment size"},
+    {"rcv_mss",        "receiver maximum segment size"},
+    {"unacked",        "number of unacknowledged segments"},
+    {"lost",           "number of segments considered lost"},
+    {"total_retrans",  "total number of retransmitted segments"},
+    {"pmtu",           "path MTU"},
+    {"cwnd_rate",      "congestion window divided by the round trip time, in bytes per second"},
+    {NULL}
+};
+
+static PyStructSequence_Desc tcp_info_result_desc = {
+    "tcp_info_result",
+    NULL,
+    tcp_info_result_fields,
+    14
+};
+
+
 /* Some helper stuff */
 
 
@@ -593,6 +1028,350 @@ pyuv_guess_ip_family(char *ip, int *address_type)
 }
 
 
+#ifdef PYUV_HAVE_TCP_INFO
+/* socket of a TCP handle. This libuv version has no uv_fileno, so it's read from the
+ * handle internals, which only works on Unix (TCP_INFO is only supported on Linux anyway) */
+static INLINE int
+pyuv_tcp_fd(uv_tcp_t *handle)
+{
+    return handle->io_watcher.fd;
+}
+#endif
+
+
+/* fill a tcp_info_result with the kernel statistics for the given TCP handle */
+static INLINE PyObject *
+pyuv_tcp_get_info(uv_tcp_t *handle)
+{
+#ifdef PYUV_HAVE_TCP_INFO
+    struct tcp_info ti;
+    socklen_t len;
+    unsigned PY_LONG_LONG cwnd_rate;
+    PyObject *info;
+
+    len = sizeof(ti);
+    memset(&ti, 0, sizeof(ti));
+    if (getsockopt(pyuv_tcp_fd(handle), IPPROTO_TCP, TCP_INFO, (void *)&ti, &len) != 0) {
+        PyErr_SetFromErrno(PyExc_TCPError);
+        return NULL;
+    }
+
+    /* not the kernel's tcpi_delivery_rate, which the libc headers don't export: cwnd * mss / rtt */
+    if (ti.tcpi_rtt > 0) {
+        cwnd_rate = (unsigned PY_LONG_LONG)ti.tcpi_snd_cwnd * ti.tcpi_snd_mss * 1000000 / ti.tcpi_rtt;
+    } else {
+        cwnd_rate = 0;
+    }
+
+    info = PyStructSequence_New(&TCPInfoResultType);
+    if (!info) {
+        return NULL;
+    }
+    PyStructSequence_SET_ITEM(info, 0, PyInt_FromLong((long)ti.tcpi_state));
+    PyStructSequence_SET_ITEM(info, 1, PyInt_FromLong((long)ti.tcpi_ca_state));
+    PyStructSequence_SET_ITEM(info, 2, PyInt_FromLong((long)ti.tcpi_retransmits));
+    PyStructSequence_SET_ITEM(info, 3, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_rtt));
+    PyStructSequence_SET_ITEM(info, 4, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_rttvar));
+    PyStructSequence_SET_ITEM(info, 5, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_snd_cwnd));
+    PyStructSequence_SET_ITEM(info, 6, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_snd_ssthresh));
+    PyStructSequence_SET_ITEM(info, 7, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_snd_mss));
+    PyStructSequence_SET_ITEM(info, 8, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_rcv_mss));
+    PyStructSequence_SET_ITEM(info, 9, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_unacked));
+    PyStructSequence_SET_ITEM(info, 10, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_lost));
+    PyStructSequence_SET_ITEM(info, 11, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_total_retrans));
+    PyStructSequence_SET_ITEM(info, 12, PyLong_FromUnsignedLong((unsigned long)ti.tcpi_pmtu));
+    PyStructSequence_SET_ITEM(info, 13, PyLong_FromUnsignedLongLong(cwnd_rate));
+    return info;
+#else
+    UNUSED_ARG(handle);
+    PyErr_SetString(PyExc_TCPError, "TCP_INFO is not supported on this platform");
+    return NULL;
+#endif
+}
+
+
+static INLINE unsigned int
+histogram_bucket(uint64_t value)
+{
+    unsigned int exp;
+
+    if (value < (1 << HISTOGRAM_SUB_BITS)) {
+        return (unsigned int)value;
+    }
+#if defined(__GNUC__)
+    exp = 63 - __builtin_clzll(value);
+#else
+    {
+        uint64_t v = value;
+        exp = 0;
+        while (v >>= 1) {
+            exp++;
+        }
+    }
+#endif
+    /* the top bit is set, so the shifted value is in [16, 32) */
+    return ((exp - HISTOGRAM_SUB_BITS) << HISTOGRAM_SUB_BITS) + (unsigned int)(value >> (exp - HISTOGRAM_SUB_BITS));
+}
+
+
+static INLINE void
+histogram_record(histogram_t *hist, uint64_t value)
+{
+    if (hist->count == 0 || value < hist->min) {
+        hist->min = value;
+    }
+    if (value > hist->max) {
+        hist->max = value;
+    }
+    hist->count++;
+    hist->sum += value;
+    hist->buckets[histogram_bucket(value)]++;
+}
+
+
+/*
+ * Acquire the GIL in a callback. When the loop runs with hold_gil the loop thread keeps
+ * the GIL and only releases it while polling for I/O, the first callback which runs after
+ * the poll takes it back for the rest of the iteration, so that PyGILState_Ensure takes
+ * its fast path. It must not be used in prepare callbacks, which run before polling.
+ */
+static INLINE PyGILState_STATE
+pyuv_gil_ensure(uv_loop_t *uv_loop)
+{
+    PyThreadState *tstate;
+    Loop *loop = (Loop *)uv_loop->data;
+
+    if (loop && loop->gil_tstate) {
+        tstate = loop->gil_tstate;
+        loop->gil_tstate = NULL;
+        PyEval_RestoreThread(tstate);
+    }
+    return PyGILState_Ensure();
+}
+
+
+static void pyuv_metrics_slow_callback(Loop *loop, PyObject *handle, PyObject *callback, uint64_t elapsed);
+
+
+/* start timing a callback, returns 0 if neither metrics nor the slow callback detector are enabled */
+static INLINE uint64_t
+pyuv_metrics_start(uv_loop_t *uv_loop)
+{
+    uint64_t now;
+    loop_metrics_t *metrics;
+    Loop *loop = (Loop *)uv_loop->data;
+
+    if (!loop || !loop->metrics || !(loop->metrics->enabled || loop->metrics->watchdog)) {
+        return 0;
+    }
+    metrics = loop->metrics;
+    now = uv_hrtime();
+    if (metrics->dispatch_start == 0) {
+        metrics->dispatch_start = now;
+    }
+    if (metrics->watchdog) {
+        metrics->watchdog->thread_ident = PyThread_get_thread_ident();
+        metrics->watchdog->seq++;
+        metrics->watchdog->start = now;
+    }
+    return now;
+}
+
+
+static INLINE void
+pyuv_metrics_end(uv_loop_t *uv_loop, int kind, uint64_t start, PyObject *handle, PyObject *callback)
+{
+    uint64_t elapsed;
+    loop_metrics_t *metrics;
+
+    if (start == 0 || !uv_loop->data) {
+        return;
+    }
+    metrics = ((Loop *)uv_loop->data)->metrics;
+    elapsed = uv_hrtime() - start;
+    if (metrics->enabled) {
+        metrics->callbacks[kind].count++;
+        metrics->callbacks[kind].time += elapsed;
+        metrics->callback_time += elapsed;
+        if (metrics->histograms_enabled) {
+            histogram_record(&metrics->histograms[kind], elapsed);
+            histogram_record(&metrics->histograms[PYUV_METRIC_KINDS + kind], start - metrics->dispatch_start);
+        }
+    }
+    if (metrics->watchdog) {
+        metrics->watchdog->start = 0;
+        if (elapsed >= metrics->watchdog->threshold) {
+            pyuv_metrics_slow_callback((Loop *)uv_loop->data, handle, callback, elapsed);
+        }
+    }
+}
+
+
+static INLINE int
+pyuv_metrics_stream_kind(uv_stream_t *handle)
+{
+    switch (handle->type) {
+        case UV_NAMED_PIPE:
+            return PYUV_METRIC_PIPE_READ;
+        case UV_TTY:
+            return PYUV_METRIC_TTY_READ;
+        default:
+            return PYUV_METRIC_TCP_READ;
+    }
+}
+
+
+#ifdef PYUV_HAVE_FASTCALL
+/* same as PyArg_UnpackTuple, for METH_FASTCALL methods */
+static int
+pyuv_unpack_stack(PyObject *const *args, Py_ssize_t nargs, const char *name, Py_ssize_t min, Py_ssize_t max, ...)
+{
+    Py_ssize_t i;
+    va_list vargs;
+
+    if (nargs < min || nargs > max) {
+        PyErr_Format(PyExc_TypeError, "%s expected %s%zd argument%s, got %zd",
+                     name,
+                     min == max ? "" : (nargs < min ? "at least " : "at most "),
+                     nargs < min ? min : max,
+                     (nargs < min ? min : max) == 1 ? "" : "s",
+                     nargs);
+        return 0;
+    }
+
+    va_start(vargs, max);
+    for (i = 0; i < nargs; i++) {
+        *va_arg(vargs, PyObject **) = args[i];
+    }
+    va_end(vargs);
+    return 1;
+}
+
+
+/* unpack the arguments of a METH_FASTCALL | METH_KEYWORDS method, given by position or by
+ * the name in kwlist, all arguments after the first min ones are optional */
+static int
+pyuv_unpack_stack_keywords(PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames, const char *name, char **kwlist, Py_ssize_t min, ...)
+{
+    Py_ssize_t i, j, max, nkwargs;
+    PyObject *kwname;
+    PyObject **values[8];
+    va_list vargs;
+
+    for (max = 0; kwlist[max]; max++);
+    ASSERT(max <= 8);
+
+    if (nargs > max) {
+        PyErr_Format(PyExc_TypeError, "%s() takes at most %zd argument%s (%zd given)", name, max, max == 1 ? "" : "s", nargs);
+        return 0;
+    }
+
+    va_start(vargs, min);
+    for (i = 0; i < max; i++) {
+        values[i] = va_arg(vargs, PyObject **);
+        if (i < nargs) {
+            *values[i] = args[i];
+        } else if (i < min) {
+            *values[i] = NULL;
+        }
+    }
+    va_end(vargs);
+
+    nkwargs = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (i = 0; i < nkwargs; i++) {
+        kwname = PyTuple_GET_ITEM(kwnames, i);
+        for (j = 0; j < max; j++) {
+            if (PyUnicode_CompareWithASCIIString(kwname, kwlist[j]) == 0) {
+                break;
+            }
+        }
+        if (j == max) {
+            PyErr_Format(PyExc_TypeError, "'%U' is an invalid keyword argument for %s()", kwname, name);
+            return 0;
+        }
+        if (j < nargs) {
+            PyErr_Format(PyExc_TypeError, "argument for %s() given by name ('%s') and position (%zd)", name, kwlist[j], j + 1);
+            return 0;
+        }
+        *values[j] = args[nargs + i];
+    }
+
+    for (i = nargs; i < min; i++) {
+        if (!*values[i]) {
+            PyErr_Format(PyExc_TypeError, "%s() missing required argument '%s' (pos %zd)", name, kwlist[i], i + 1);
+            return 0;
+        }
+    }
+    return 1;
+}
+#endif
+
+
+/* Call a callback with the given positional arguments. With vectorcall no arguments tuple
+ * is built, and the extra slot in front of the arguments lets bound methods prepend self
+ * without copying them. */
+#ifdef PYUV_HAVE_VECTORCALL
+    #define PYUV_VECTORCALL(callable, args, nargs) PyObject_Vectorcall(callable, (args) + 1, (nargs) | PY_VECTORCALL_ARGUMENTS_OFFSET, NULL)
+#endif
+
+static INLINE PyObject *
+pyuv_call1(PyObject *callable, PyObject *arg1)
+{
+#ifdef PYUV_HAVE_VECTORCALL
+    PyObject *args[2];
+    args[1] = arg1;
+    return PYUV_VECTORCALL(callable, args, 1);
+#else
+    return PyObject_CallFunctionObjArgs(callable, arg1, NULL);
+#endif
+}
+
+
+static INLINE PyObject *
+pyuv_call2(PyObject *callable, PyObject *arg1, PyObject *arg2)
+{
+#ifdef PYUV_HAVE_VECTORCALL
+    PyObject *args[3];
+    args[1] = arg1;
+    args[2] = arg2;
+    return PYUV_VECTORCALL(callable, args, 2);
+#else
+    return PyObject_CallFunctionObjArgs(callable, arg1, arg2, NULL);
+#endif
+}
+
+
+static INLINE PyObject *
+pyuv_call3(PyObject *callable, PyObject *arg1, PyObject *arg2, PyObject *arg3)
+{
+#ifdef PYUV_HAVE_VECTORCALL
+    PyObject *args[4];
+    args[1] = arg1;
+    args[2] = arg2;
+    args[3] = arg3;
+    return PYUV_VECTORCALL(callable, args, 3);
+#else
+    return PyObject_CallFunctionObjArgs(callable, arg1, arg2, arg3, NULL);
+#endif
+}
+
+
+static INLINE PyObject *
+pyuv_call4(PyObject *callable, PyObject *arg1, PyObject *arg2, PyObject *arg3, PyObject *arg4)
+{
+#ifdef PYUV_HAVE_VECTORCALL
+    PyObject *args[5];
+    args[1] = arg1;
+    args[2] = arg2;
+    args[3] = arg3;
+    args[4] = arg4;
+    return PYUV_VECTORCALL(callable, args, 4);
+#else
+    return PyObject_CallFunctionObjArgs(callable, arg1, arg2, arg3, arg4, NULL);
+#endif
+}
+
+
 /* handle uncausht exception in a callback */
 static INLINE void
 handle_uncaught_exception(Loop *loop)
@@ -614,7 +1393,7 @@ handle_uncaught_exception(Loop *loop)
     }
 
     if (loop->excepthook_cb != NULL && loop->excepthook_cb != Py_None) {
-        result = PyObject_CallFunctionObjArgs(loop->excepthook_cb, type, val, tb, NULL);
+        result = pyuv_call3(loop->excepthook_cb, type, val, tb);
         Py_XDECREF(result);
     } else {
         PyErr_Display(type, val, tb);
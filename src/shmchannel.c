@@ -0,0 +1,578 @@
+
+#ifdef PYUV_HAVE_SHM_CHANNEL
+
+/*
+ * Single producer / single consumer ring buffer living in a shared memory segment.
+ * Each message is stored as a 32 bit length followed by the payload, both of which
+ * can wrap around the end of the ring. head and tail are free running counters,
+ * only the producer writes head and only the consumer writes tail. The producer
+ * signals the eventfd only when the ring was empty, the consumer drains everything
+ * it finds on each wakeup and delivers it in a single callback. If the consumer
+ * finds a corrupted message the channel is marked as failed in the shared header,
+ * both ends raise from then on.
+ */
+
+#define RAISE_IF_SHM_CHANNEL_FAILED(obj)                                    \
+    do {                                                                    \
+        if (shm_channel_load(&(obj)->header->failed)) {                     \
+            PyErr_SetString(PyExc_ShmChannelError,                          \
+                            "Corrupted message found in the channel");      \
+            return NULL;                                                    \
+        }                                                                   \
+    } while(0)                                                              \
+
+
+static unsigned int shm_channel_counter = 0;
+
+
+static INLINE uint64_t
+shm_channel_load(volatile uint64_t *ptr)
+{
+    uint64_t value = *ptr;
+    __sync_synchronize();
+    return value;
+}
+
+
+static INLINE void
+shm_channel_store(volatile uint64_t *ptr, uint64_t value)
+{
+    __sync_synchronize();
+    *ptr = value;
+    __sync_synchronize();
+}
+
+
+static INLINE void
+shm_channel_copy_in(ShmChannel *self, uint64_t pos, const char *data, size_t len)
+{
+    size_t offset, chunk;
+
+    offset = (size_t)(pos % self->capacity);
+    chunk = self->capacity - offset;
+    if (chunk >= len) {
+        memcpy(self->data + offset, data, len);
+    } else {
+        memcpy(self->data + offset, data, chunk);
+        memcpy(self->data, data + chunk, len - chunk);
+    }
+}
+
+
+static INLINE void
+shm_channel_copy_out(ShmChannel *self, uint64_t pos, char *data, size_t len)
+{
+    size_t offset, chunk;
+
+    offset = (size_t)(pos % self->capacity);
+    chunk = self->capacity - offset;
+    if (chunk >= len) {
+        memcpy(data, self->data + offset, len);
+    } else {
+        memcpy(data, self->data + offset, chunk);
+        memcpy(data + chunk, self->data, len - chunk);
+    }
+}
+
+
+/* read all available messages, returns a new list or NULL on error */
+static PyObject *
+shm_channel_drain(ShmChannel *self)
+{
+    uint32_t len;
+    uint64_t head, tail;
+    PyObject *messages, *item;
+
+    RAISE_IF_SHM_CHANNEL_FAILED(self);
+
+    messages = PyList_New(0);
+    if (!messages) {
+        return NULL;
+    }
+
+    tail = self->header->tail;
+    for (;;) {
+        head = shm_channel_load(&self->header->head);
+        if (head == tail) {
+            break;
+        }
+        while (tail != head) {
+            shm_channel_copy_out(self, tail, (char *)&len, sizeof(len));
+            if ((uint64_t)len + sizeof(len) > head - tail) {
+                /* nothing after this point can be parsed: drop it and mark the channel as failed,
+                 * the messages read so far are still delivered */
+                shm_channel_store(&self->header->failed, 1);
+                shm_channel_store(&self->header->tail, head);
+                return messages;
+            }
+            item = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)len);
+            if (!item) {
+                Py_DECREF(messages);
+                return NULL;
+            }
+            shm_channel_copy_out(self, tail + sizeof(len), PyBytes_AS_STRING(item), len);
+            tail += sizeof(len) + len;
+            if (PyList_Append(messages, item) != 0) {
+                Py_DECREF(item);
+                Py_DECREF(messages);
+                return NULL;
+            }
+            Py_DECREF(item);
+        }
+        /* publish the new tail and look again, the producer won't signal if it saw data pending */
+        shm_channel_store(&self->header->tail, tail);
+    }
+
+    return messages;
+}
+
+
+static void
+on_shm_channel_poll(uv_poll_t *handle, int status, int events)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    uint64_t value;
+    uv_err_t err;
+    ShmChannel *self;
+    PyObject *result, *messages, *py_errorno;
+
+    ASSERT(handle);
+    UNUSED_ARG(events);
+
+    self = (ShmChannel *)handle->data;
+    ASSERT(self);
+    /* Object could go out of scope in the callback, increase refcount to avoid it */
+    Py_INCREF(self);
+
+    if (status == 0) {
+        /* reset the eventfd counter before looking at the ring, so no wakeup is lost */
+        while (read(self->event_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+        messages = shm_channel_drain(self);
+        if (!messages) {
+            handle_uncaught_exception(((Handle *)self)->loop);
+            goto done;
+        }
+        if (PyList_GET_SIZE(messages) == 0) {
+            /* spurious wakeup */
+            Py_DECREF(messages);
+            goto check;
+        }
+        py_errorno = Py_None;
+        Py_INCREF(Py_None);
+    } else {
+        messages = Py_None;
+        Py_INCREF(Py_None);
+        err = uv_last_error(UV_HANDLE_LOOP(self));
+        py_errorno = PyInt_FromLong((long)err.code);
+    }
+
+    result = pyuv_call3(self->callback, (PyObject *)self, messages, py_errorno);
+    if (result == NULL) {
+        handle_uncaught_exception(((Handle *)self)->loop);
+    }
+    Py_XDECREF(result);
+    Py_DECREF(messages);
+    Py_DECREF(py_errorno);
+
+check:
+    /* the callback may have closed the channel */
+    if (self->header && shm_channel_load(&self->header->failed) && !UV_HANDLE_CLOSED(self)) {
+        uv_poll_stop((uv_poll_t *)UV_HANDLE(self));
+        PyErr_SetString(PyExc_ShmChannelError, "Corrupted message found in the channel");
+        handle_uncaught_exception(((Handle *)self)->loop);
+    }
+
+done:
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+static PyObject *
+ShmChannel_func_send(ShmChannel *self, PyObject *args)
+{
+    uint32_t len;
+    uint64_t head, tail, value;
+    Py_buffer pbuf;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+    RAISE_IF_SHM_CHANNEL_FAILED(self);
+
+    if (!PyArg_ParseTuple(args, "s*:send", &pbuf)) {
+        return NULL;
+    }
+
+    if ((size_t)pbuf.len + sizeof(len) > self->capacity || pbuf.len > (Py_ssize_t)UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "message is too big for the channel");
+        PyBuffer_Release(&pbuf);
+        return NULL;
+    }
+
+    len = (uint32_t)pbuf.len;
+    head = self->header->head;
+    tail = shm_channel_load(&self->header->tail);
+    if (self->capacity - (head - tail) < sizeof(len) + len) {
+        PyErr_SetString(PyExc_ShmChannelError, "Channel is full");
+        PyBuffer_Release(&pbuf);
+        return NULL;
+    }
+
+    shm_channel_copy_in(self, head, (const char *)&len, sizeof(len));
+    shm_channel_copy_in(self, head + sizeof(len), pbuf.buf, len);
+    PyBuffer_Release(&pbuf);
+
+    shm_channel_store(&self->header->head, head + sizeof(len) + len);
+
+    /* the consumer is only woken up if it may have already drained the ring */
+    if (shm_channel_load(&self->header->tail) == head) {
+        value = 1;
+        while (write(self->event_fd, &value, sizeof(value)) < 0 && errno == EINTR);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+ShmChannel_func_start(ShmChannel *self, PyObject *args)
+{
+    int r;
+    PyObject *tmp, *callback;
+
+    tmp = NULL;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+    RAISE_IF_SHM_CHANNEL_FAILED(self);
+
+    if (!PyArg_ParseTuple(args, "O:start", &callback)) {
+        return NULL;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    r = uv_poll_start((uv_poll_t *)UV_HANDLE(self), UV_READABLE, on_shm_channel_poll);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_ShmChannelError);
+        return NULL;
+    }
+
+    tmp = self->callback;
+    Py_INCREF(callback);
+    self->callback = callback;
+    Py_XDECREF(tmp);
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+ShmChannel_func_stop(ShmChannel *self)
+{
+    int r;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    r = uv_poll_stop((uv_poll_t *)UV_HANDLE(self));
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_ShmChannelError);
+        return NULL;
+    }
+
+    Py_XDECREF(self->callback);
+    self->callback = NULL;
+
+    Py_RETURN_NONE;
+}
+
+
+/* unmap the segment and close the descriptors, the poll handle must be closed already */
+static void
+shm_channel_release(ShmChannel *self)
+{
+    if (self->header) {
+        munmap((void *)self->header, self->size);
+        self->header = NULL;
+        self->data = NULL;
+    }
+    if (self->shm_fd != -1) {
+        close(self->shm_fd);
+        self->shm_fd = -1;
+    }
+    if (self->event_fd != -1) {
+        close(self->event_fd);
+        self->event_fd = -1;
+    }
+}
+
+
+static PyObject *
+ShmChannel_func_close(ShmChannel *self, PyObject *args)
+{
+    PyObject *result;
+
+    result = Handle_func_close((Handle *)self, args);
+    if (result) {
+        /* uv_close stops polling right away, so the descriptors can be closed now */
+        shm_channel_release(self);
+    }
+    return result;
+}
+
+
+static PyObject *
+ShmChannel_fds_get(ShmChannel *self, void *closure)
+{
+    UNUSED_ARG(closure);
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    return Py_BuildValue("(ii)", self->shm_fd, self->event_fd);
+}
+
+
+static PyObject *
+ShmChannel_pending_get(ShmChannel *self, void *closure)
+{
+    UNUSED_ARG(closure);
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)(shm_channel_load(&self->header->head) - shm_channel_load(&self->header->tail)));
+}
+
+
+static int
+ShmChannel_tp_init(ShmChannel *self, PyObject *args, PyObject *kwargs)
+{
+    int r, shm_fd, event_fd;
+    char name[64];
+    long page_size;
+    Py_ssize_t size;
+    void *ptr;
+    struct stat st;
+    uv_poll_t *uv_poll = NULL;
+    Loop *loop;
+    PyObject *tmp, *fds;
+
+    static char *kwlist[] = {"loop", "size", "fds", NULL};
+
+    tmp = NULL;
+    fds = Py_None;
+    size = 65536;
+    shm_fd = event_fd = -1;
+    ptr = NULL;
+
+    if (UV_HANDLE(self)) {
+        PyErr_SetString(PyExc_ShmChannelError, "Object already initialized");
+        return -1;
+    }
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|nO:__init__", kwlist, &LoopType, &loop, &size, &fds)) {
+        return -1;
+    }
+
+    page_size = sysconf(_SC_PAGESIZE);
+
+    if (fds == Py_None) {
+        if (size <= 0) {
+            PyErr_SetString(PyExc_ValueError, "a positive value is required");
+            return -1;
+        }
+        /* the header takes the first page, the ring takes the rest */
+        size = ((size + page_size - 1) / page_size + 1) * page_size;
+
+        PyOS_snprintf(name, sizeof(name), "/pyuv-shm-%ld-%u", (long)getpid(), shm_channel_counter++);
+        shm_fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (shm_fd == -1) {
+            PyErr_SetFromErrno(PyExc_ShmChannelError);
+            return -1;
+        }
+        /* the segment is only reachable through the descriptor from now on */
+        shm_unlink(name);
+        if (ftruncate(shm_fd, (off_t)size) != 0) {
+            PyErr_SetFromErrno(PyExc_ShmChannelError);
+            goto error;
+        }
+        event_fd = eventfd(0, EFD_NONBLOCK);
+        if (event_fd == -1) {
+            PyErr_SetFromErrno(PyExc_ShmChannelError);
+            goto error;
+        }
+    } else {
+        if (!PyArg_ParseTuple(fds, "ii:__init__", &shm_fd, &event_fd)) {
+            return -1;
+        }
+        if (fstat(shm_fd, &st) != 0) {
+            PyErr_SetFromErrno(PyExc_ShmChannelError);
+            return -1;
+        }
+        size = (Py_ssize_t)st.st_size;
+        if (size <= page_size) {
+            PyErr_SetString(PyExc_ShmChannelError, "Invalid shared memory segment");
+            return -1;
+        }
+    }
+
+    ptr = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (ptr == MAP_FAILED) {
+        ptr = NULL;
+        PyErr_SetFromErrno(PyExc_ShmChannelError);
+        goto error;
+    }
+
+    uv_poll = PyMem_Malloc(sizeof(uv_poll_t));
+    if (!uv_poll) {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    r = uv_poll_init(loop->uv_loop, uv_poll, event_fd);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(loop->uv_loop, PyExc_ShmChannelError);
+        PyMem_Free(uv_poll);
+        goto error;
+    }
+    uv_poll->data = (void *)self;
+    /* kept out of the object, the descriptors are released right after closing it in tp_dealloc */
+    UV_HANDLE(self) = (uv_handle_t *)uv_poll;
+    ((Handle *)self)->uv_handle_external = True;
+
+    tmp = (PyObject *)((Handle *)self)->loop;
+    Py_INCREF(loop);
+    ((Handle *)self)->loop = loop;
+    Py_XDECREF(tmp);
+
+    self->header = (shm_channel_header_t *)ptr;
+    self->data = (char *)ptr + page_size;
+    self->size = (size_t)size;
+    self->capacity = (size_t)(size - page_size);
+    self->shm_fd = shm_fd;
+    self->event_fd = event_fd;
+
+    return 0;
+
+error:
+    if (ptr) {
+        munmap(ptr, (size_t)size);
+    }
+    /* descriptors given by the user are not ours to close */
+    if (fds == Py_None) {
+        if (shm_fd != -1) {
+            close(shm_fd);
+        }
+        if (event_fd != -1) {
+            close(event_fd);
+        }
+    }
+    return -1;
+}
+
+
+static PyObject *
+ShmChannel_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    ShmChannel *self = (ShmChannel *)HandleType.tp_new(type, args, kwargs);
+    if (!self) {
+        return NULL;
+    }
+    self->header = NULL;
+    self->data = NULL;
+    self->shm_fd = -1;
+    self->event_fd = -1;
+    return (PyObject *)self;
+}
+
+
+static void
+ShmChannel_tp_dealloc(ShmChannel *self)
+{
+    if (UV_HANDLE(self)) {
+        uv_close(UV_HANDLE(self), on_handle_dealloc_close);
+        UV_HANDLE(self) = NULL;
+    }
+    shm_channel_release(self);
+    HandleType.tp_dealloc((PyObject *)self);
+}
+
+
+static int
+ShmChannel_tp_traverse(ShmChannel *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->callback);
+    HandleType.tp_traverse((PyObject *)self, visit, arg);
+    return 0;
+}
+
+
+static int
+ShmChannel_tp_clear(ShmChannel *self)
+{
+    Py_CLEAR(self->callback);
+    HandleType.tp_clear((PyObject *)self);
+    return 0;
+}
+
+
+static PyMethodDef
+ShmChannel_tp_methods[] = {
+    { "send", (PyCFunction)ShmChannel_func_send, METH_VARARGS, "Send a message through the channel." },
+    { "start", (PyCFunction)ShmChannel_func_start, METH_VARARGS, "Start receiving messages." },
+    { "stop", (PyCFunction)ShmChannel_func_stop, METH_NOARGS, "Stop receiving messages." },
+    { "close", (PyCFunction)ShmChannel_func_close, METH_VARARGS, "Close the channel." },
+    { NULL }
+};
+
+
+static PyGetSetDef ShmChannel_tp_getsets[] = {
+    {"fds", (getter)ShmChannel_fds_get, NULL, "Shared memory and eventfd file descriptors.", NULL},
+    {"pending", (getter)ShmChannel_pending_get, NULL, "Amount of bytes waiting to be read.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject ShmChannelType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.ShmChannel",                                              /*tp_name*/
+    sizeof(ShmChannel),                                             /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)ShmChannel_tp_dealloc,                              /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)ShmChannel_tp_traverse,                           /*tp_traverse*/
+    (inquiry)ShmChannel_tp_clear,                                   /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    ShmChannel_tp_methods,                                          /*tp_methods*/
+    0,                                                              /*tp_members*/
+    ShmChannel_tp_getsets,                                          /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    (initproc)ShmChannel_tp_init,                                   /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    ShmChannel_tp_new,                                              /*tp_new*/
+};
+
+#endif
+
@@ -2,7 +2,7 @@
 static void
 on_signal_callback(uv_signal_t *handle, int signum)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     Signal *self;
     PyObject *result;
 
@@ -13,7 +13,7 @@ on_signal_callback(uv_signal_t *handle, int signum)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, PyInt_FromLong((long)signum), NULL);
+    result = pyuv_call2(self->callback, (PyObject *)self, PyInt_FromLong((long)signum));
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -99,12 +99,7 @@ Signal_tp_init(Signal *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_signal = PyMem_Malloc(sizeof(uv_signal_t));
-    if (!uv_signal) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_signal = &self->signal_h;
 
     r = uv_signal_init(UV_HANDLE_LOOP(self), uv_signal);
     if (r != 0) {
@@ -207,13 +202,30 @@ static PyTypeObject SignalType = {
     } while (0)                                         \
 
 
-#define RAISE_IF_SIGNAL_CHECKER_CLOSED(self)                                                                                                                                \
-    do {                                                                                                                                                                    \
-        if (!self->prepare_handle || uv_is_closing((uv_handle_t *)self->prepare_handle) || !self->check_handle || uv_is_closing((uv_handle_t *)self->check_handle)) {       \
-            PyErr_SetString(PyExc_SignalCheckerError, "Signal checker is closed");                                                                                          \
-            return NULL;                                                                                                                                                    \
-        }                                                                                                                                                                   \
-    } while (0)                                                                                                                                                             \
+/*
+ * SignalChecker has two modes. When a wakeup fd is given (see signal.set_wakeup_fd) only its read
+ * end is polled: the interpreter writes a byte to it when a signal arrives, so Python is entered
+ * only when a signal is pending. Otherwise signals are checked from a prepare and a check handle,
+ * which run on every loop iteration.
+ */
+
+#define RAISE_IF_SIGNAL_CHECKER_CLOSED(self)                                            \
+    do {                                                                                \
+        if (signal_checker_closed(self)) {                                              \
+            PyErr_SetString(PyExc_SignalCheckerError, "Signal checker is closed");      \
+            return NULL;                                                                \
+        }                                                                               \
+    } while (0)                                                                         \
+
+
+static Bool
+signal_checker_closed(SignalChecker *self)
+{
+    if (self->fd != -1) {
+        return !self->poll_handle || uv_is_closing((uv_handle_t *)self->poll_handle);
+    }
+    return !self->prepare_handle || uv_is_closing((uv_handle_t *)self->prepare_handle) || !self->check_handle || uv_is_closing((uv_handle_t *)self->check_handle);
+}
 
 
 static void
@@ -235,7 +247,7 @@ on_signal_checker_prepare_cb(uv_prepare_t *handle, int status)
 static void
 on_signal_checker_check_cb(uv_check_t *handle, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     SignalChecker *self;
 
     ASSERT(handle);
@@ -248,6 +260,36 @@ on_signal_checker_check_cb(uv_check_t *handle, int status)
 }
 
 
+static void
+on_signal_checker_poll_cb(uv_poll_t *handle, int status, int events)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    char buf[512];
+    SignalChecker *self;
+
+    ASSERT(handle);
+    UNUSED_ARG(events);
+    self = (SignalChecker *)handle->data;
+    ASSERT(self);
+
+    /* consume the bytes written by the signal handler, a single read can't block. If more
+     * signals are pending the fd stays readable and signals are checked again anyway */
+    if (status == 0) {
+#ifdef PYUV_WINDOWS
+        recv((SOCKET)self->fd, buf, sizeof(buf), 0);
+#else
+        if (read(self->fd, buf, sizeof(buf)) == -1) {
+            /* nothing to read, another handle drained it */
+        }
+#endif
+    }
+
+    PYUV_CHECK_SIGNALS(self);
+
+    PyGILState_Release(gstate);
+}
+
+
 static PyObject *
 SignalChecker_func_start(SignalChecker *self)
 {
@@ -256,6 +298,16 @@ SignalChecker_func_start(SignalChecker *self)
 
     RAISE_IF_SIGNAL_CHECKER_CLOSED(self);
 
+    if (self->fd != -1) {
+        r = uv_poll_start(self->poll_handle, UV_READABLE, on_signal_checker_poll_cb);
+        if (r != 0) {
+            RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_SignalCheckerError);
+            return NULL;
+        }
+        uv_unref((uv_handle_t *)self->poll_handle);
+        Py_RETURN_NONE;
+    }
+
     r = uv_prepare_start(self->prepare_handle, on_signal_checker_prepare_cb);
     if (r != 0) {
         RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_SignalCheckerError);
@@ -290,6 +342,15 @@ SignalChecker_func_stop(SignalChecker *self)
 
     RAISE_IF_SIGNAL_CHECKER_CLOSED(self);
 
+    if (self->fd != -1) {
+        r = uv_poll_stop(self->poll_handle);
+        if (r != 0) {
+            RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_SignalCheckerError);
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
+
     r = uv_prepare_stop(self->prepare_handle);
     if (r != 0) {
         RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_SignalCheckerError);
@@ -311,6 +372,25 @@ SignalChecker_func_stop(SignalChecker *self)
 }
 
 
+/* close the handles, the memory is freed once they are closed */
+static void
+signal_checker_close_handles(SignalChecker *self)
+{
+    if (self->prepare_handle) {
+        uv_close((uv_handle_t *)self->prepare_handle, on_handle_dealloc_close);
+        self->prepare_handle = NULL;
+    }
+    if (self->check_handle) {
+        uv_close((uv_handle_t *)self->check_handle, on_handle_dealloc_close);
+        self->check_handle = NULL;
+    }
+    if (self->poll_handle) {
+        uv_close((uv_handle_t *)self->poll_handle, on_handle_dealloc_close);
+        self->poll_handle = NULL;
+    }
+}
+
+
 static PyObject *
 SignalChecker_func_close(SignalChecker *self, PyObject *args)
 {
@@ -320,8 +400,7 @@ SignalChecker_func_close(SignalChecker *self, PyObject *args)
     self->loop = (Loop *)Py_None;
     Py_INCREF(Py_None);
 
-    uv_close((uv_handle_t *)self->prepare_handle, on_handle_dealloc_close);
-    uv_close((uv_handle_t *)self->check_handle, on_handle_dealloc_close);
+    signal_checker_close_handles(self);
 
     Py_RETURN_NONE;
 }
@@ -331,6 +410,9 @@ static PyObject *
 SignalChecker_active_get(SignalChecker *self, void *closure)
 {
     UNUSED_ARG(closure);
+    if (self->fd != -1) {
+        return PyBool_FromLong((long)(self->poll_handle && uv_is_active((uv_handle_t *)self->poll_handle)));
+    }
     if (!self->prepare_handle || !self->check_handle) {
         Py_RETURN_FALSE;
     } else {
@@ -343,6 +425,9 @@ static PyObject *
 SignalChecker_closed_get(SignalChecker *self, void *closure)
 {
     UNUSED_ARG(closure);
+    if (self->fd != -1) {
+        return PyBool_FromLong((long)(!self->poll_handle || uv_is_closing((uv_handle_t *)self->poll_handle)));
+    }
     if (!self->prepare_handle || !self->check_handle) {
         Py_RETURN_TRUE;
     } else {
@@ -354,21 +439,29 @@ SignalChecker_closed_get(SignalChecker *self, void *closure)
 static int
 SignalChecker_tp_init(SignalChecker *self, PyObject *args, PyObject *kwargs)
 {
-    int r;
+    int r, fd;
     Bool error = False;
     uv_prepare_t *uv_prepare = NULL;
     uv_check_t *uv_check = NULL;
+    uv_poll_t *uv_poll = NULL;
     Loop *loop;
     PyObject *tmp = NULL;
 
     UNUSED_ARG(kwargs);
 
-    if (self->prepare_handle || self->check_handle) {
+    fd = -1;
+
+    if (self->prepare_handle || self->check_handle || self->poll_handle) {
         PyErr_SetString(PyExc_SignalCheckerError, "Object already initialized");
         return -1;
     }
 
-    if (!PyArg_ParseTuple(args, "O!:__init__", &LoopType, &loop)) {
+    if (!PyArg_ParseTuple(args, "O!|i:__init__", &LoopType, &loop, &fd)) {
+        return -1;
+    }
+
+    if (fd < -1) {
+        PyErr_SetString(PyExc_ValueError, "invalid file descriptor");
         return -1;
     }
 
@@ -377,6 +470,23 @@ SignalChecker_tp_init(SignalChecker *self, PyObject *args, PyObject *kwargs)
     self->loop = loop;
     Py_XDECREF(tmp);
 
+    if (fd != -1) {
+        uv_poll = PyMem_Malloc(sizeof(uv_poll_t));
+        if (!uv_poll) {
+            PyErr_NoMemory();
+            goto error;
+        }
+        r = uv_poll_init_socket(UV_LOOP(self), uv_poll, (uv_os_sock_t)fd);
+        if (r != 0) {
+            RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_SignalCheckerError);
+            goto error;
+        }
+        uv_poll->data = (void *)self;
+        self->poll_handle = uv_poll;
+        self->fd = fd;
+        return 0;
+    }
+
     uv_prepare = PyMem_Malloc(sizeof(uv_prepare_t));
     if (!uv_prepare) {
         PyErr_NoMemory();
@@ -419,6 +529,9 @@ error:
     if (uv_check) {
         PyMem_Free(uv_check);
     }
+    if (uv_poll) {
+        PyMem_Free(uv_poll);
+    }
     Py_DECREF(loop);
     return -1;
 }
@@ -433,6 +546,8 @@ SignalChecker_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
     }
     self->prepare_handle = NULL;
     self->check_handle = NULL;
+    self->poll_handle = NULL;
+    self->fd = -1;
     return (PyObject *)self;
 }
 
@@ -456,12 +571,7 @@ SignalChecker_tp_clear(SignalChecker *self)
 static void
 SignalChecker_tp_dealloc(SignalChecker *self)
 {
-    if (self->prepare_handle) {
-        uv_close((uv_handle_t *)self->prepare_handle, on_handle_dealloc_close);
-    }
-    if (self->check_handle) {
-        uv_close((uv_handle_t *)self->check_handle, on_handle_dealloc_close);
-    }
+    signal_checker_close_handles(self);
     Py_TYPE(self)->tp_clear((PyObject *)self);
     Py_TYPE(self)->tp_free((PyObject *)self);
 }
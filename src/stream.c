@@ -12,17 +12,15 @@ typedef struct {
 static uv_buf_t
 on_stream_alloc(uv_stream_t* handle, size_t suggested_size)
 {
-    static char slab[65536];
-    ASSERT(suggested_size <= sizeof(slab));
-    UNUSED_ARG(handle);
-    return uv_buf_init(slab, sizeof(slab));
+    ASSERT(suggested_size <= PYUV_READ_SLAB_SIZE);
+    return loop_read_buffer(handle->loop);
 }
 
 
 static void
 on_stream_shutdown(uv_shutdown_t* req, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
     uv_err_t err;
     Stream *self;
     PyObject *callback, *result, *py_errorno;
@@ -42,7 +40,7 @@ on_stream_shutdown(uv_shutdown_t* req, int status)
             py_errorno = Py_None;
             Py_INCREF(Py_None);
         }
-        result = PyObject_CallFunctionObjArgs(callback, self, py_errorno, NULL);
+        result = pyuv_call2(callback, (PyObject *)self, py_errorno);
         if (result == NULL) {
             handle_uncaught_exception(((Handle *)self)->loop);
         }
@@ -61,10 +59,11 @@ on_stream_shutdown(uv_shutdown_t* req, int status)
 static void
 on_stream_read(uv_stream_t* handle, int nread, uv_buf_t buf)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     uv_err_t err;
     Stream *self;
     PyObject *result, *data, *py_errorno;
+    uint64_t start;
     ASSERT(handle);
 
     self = (Stream *)handle->data;
@@ -72,6 +71,10 @@ on_stream_read(uv_stream_t* handle, int nread, uv_buf_t buf)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
+    if (nread > 0 && self->on_timeout_cb) {
+        self->last_read = (uint64_t)uv_now(UV_HANDLE_LOOP(self));
+    }
+
     if (nread >= 0) {
         data = PyBytes_FromStringAndSize(buf.base, nread);
         py_errorno = Py_None;
@@ -83,7 +86,9 @@ on_stream_read(uv_stream_t* handle, int nread, uv_buf_t buf)
         py_errorno = PyInt_FromLong((long)err.code);
     }
 
-    result = PyObject_CallFunctionObjArgs(self->on_read_cb, self, data, py_errorno, NULL);
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call3(self->on_read_cb, (PyObject *)self, data, py_errorno);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), pyuv_metrics_stream_kind(handle), start, (PyObject *)self, self->on_read_cb);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -99,7 +104,7 @@ on_stream_read(uv_stream_t* handle, int nread, uv_buf_t buf)
 static void
 on_stream_write(uv_write_t* req, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
     int i;
     stream_write_data_t* req_data;
     Stream *self;
@@ -116,6 +121,10 @@ on_stream_write(uv_write_t* req, int status)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
+    if (status == 0 && self->on_timeout_cb) {
+        self->last_write = (uint64_t)uv_now(UV_HANDLE_LOOP(self));
+    }
+
     if (callback != Py_None) {
         if (status < 0) {
             err = uv_last_error(UV_HANDLE_LOOP(self));
@@ -124,7 +133,7 @@ on_stream_write(uv_write_t* req, int status)
             py_errorno = Py_None;
             Py_INCREF(Py_None);
         }
-        result = PyObject_CallFunctionObjArgs(callback, self, py_errorno, NULL);
+        result = pyuv_call2(callback, (PyObject *)self, py_errorno);
         if (result == NULL) {
             handle_uncaught_exception(((Handle *)self)->loop);
         }
@@ -149,6 +158,178 @@ on_stream_write(uv_write_t* req, int status)
 }
 
 
+/*
+ * Idle timeouts. Reads and writes only record a timestamp, the stream is kept in a
+ * per-loop timer wheel and the deadlines are checked again when its entry expires.
+ */
+
+/* granularity of stream timeouts, in milliseconds */
+#define PYUV_STREAM_TIMEOUT_TICK 100
+
+static void
+stream_timeout_schedule(Stream *self)
+{
+    uint64_t now, deadline;
+
+    now = (uint64_t)uv_now(UV_HANDLE_LOOP(self));
+    deadline = (uint64_t)-1;
+    if (self->read_idle > 0) {
+        deadline = self->last_read + self->read_idle;
+    }
+    if (self->write_idle > 0 && self->last_write + self->write_idle < deadline) {
+        deadline = self->last_write + self->write_idle;
+    }
+
+    timer_wheel_add(((Handle *)self)->loop->stream_timeouts, &self->timeout_entry, (deadline > now) ? deadline - now : 0);
+}
+
+
+static void
+stream_timeout_clear(Stream *self)
+{
+    PyObject *callback = self->on_timeout_cb;
+
+    if (!callback) {
+        return;
+    }
+
+    timer_wheel_remove(((Handle *)self)->loop->stream_timeouts, &self->timeout_entry);
+    self->on_timeout_cb = NULL;
+    Py_DECREF(callback);
+    /* reference was taken in Stream_func_set_timeout */
+    Py_DECREF(self);
+}
+
+
+static INLINE void
+stream_timeout_fire(Stream *self, int events)
+{
+    PyObject *result, *py_events;
+
+    py_events = PyInt_FromLong((long)events);
+    result = pyuv_call2(self->on_timeout_cb, (PyObject *)self, py_events);
+    if (result == NULL) {
+        handle_uncaught_exception(((Handle *)self)->loop);
+    }
+    Py_XDECREF(result);
+    Py_XDECREF(py_events);
+}
+
+
+static void
+on_stream_timeouts_expired(timer_wheel_t *wheel, tw_entry_t *expired)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(wheel->timer_handle.loop);
+    uint64_t now;
+    tw_entry_t *entry;
+    Stream *self;
+
+    while (!tw_list_empty(expired)) {
+        entry = expired->next;
+        tw_entry_unlink(entry);
+        self = container_of(entry, Stream, timeout_entry);
+        /* Object could go out of scope in the callback, increase refcount to avoid it */
+        Py_INCREF(self);
+
+        now = (uint64_t)uv_now(wheel->timer_handle.loop);
+        if (self->on_timeout_cb && self->read_idle > 0 && now - self->last_read >= self->read_idle) {
+            self->last_read = now;
+            stream_timeout_fire(self, UV_READABLE);
+        }
+        if (self->on_timeout_cb && self->write_idle > 0 && now - self->last_write >= self->write_idle) {
+            self->last_write = now;
+            stream_timeout_fire(self, UV_WRITABLE);
+        }
+
+        /* the callback could have closed the stream or changed the timeouts */
+        if (UV_HANDLE_CLOSED(self)) {
+            stream_timeout_clear(self);
+        } else if (self->on_timeout_cb && !tw_entry_active(&self->timeout_entry)) {
+            stream_timeout_schedule(self);
+        }
+
+        Py_DECREF(self);
+    }
+
+    PyGILState_Release(gstate);
+}
+
+
+static PyObject *
+Stream_func_set_timeout(Stream *self, PyObject *args, PyObject *kwargs)
+{
+    double read_idle, write_idle;
+    Loop *loop;
+    PyObject *tmp, *callback;
+
+    static char *kwlist[] = {"callback", "read_idle", "write_idle", NULL};
+
+    read_idle = write_idle = 0.0;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|dd:set_timeout", kwlist, &callback, &read_idle, &write_idle)) {
+        return NULL;
+    }
+
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable or None is required");
+        return NULL;
+    }
+
+    if (!(read_idle >= 0.0) || !(write_idle >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    if (read_idle * 1000 >= (double)TIMER_WHEEL_MAX_TIMEOUT || write_idle * 1000 >= (double)TIMER_WHEEL_MAX_TIMEOUT) {
+        PyErr_SetString(PyExc_OverflowError, "timeout is too large");
+        return NULL;
+    }
+
+    if (callback == Py_None || (read_idle == 0.0 && write_idle == 0.0)) {
+        stream_timeout_clear(self);
+        Py_RETURN_NONE;
+    }
+
+    loop = ((Handle *)self)->loop;
+    if (!loop->stream_timeouts) {
+        loop->stream_timeouts = timer_wheel_new(loop->uv_loop, PYUV_STREAM_TIMEOUT_TICK, 6, on_stream_timeouts_expired);
+        if (!loop->stream_timeouts) {
+            return NULL;
+        }
+        /* the streams keep the loop alive, not their timeouts */
+        uv_unref((uv_handle_t *)&loop->stream_timeouts->timer_handle);
+    }
+
+    tmp = self->on_timeout_cb;
+    Py_INCREF(callback);
+    self->on_timeout_cb = callback;
+    if (tmp) {
+        Py_DECREF(tmp);
+    } else {
+        /* keep the stream alive while it's in the wheel, released in stream_timeout_clear */
+        Py_INCREF(self);
+    }
+
+    self->read_idle = (uint64_t)(read_idle * 1000);
+    self->write_idle = (uint64_t)(write_idle * 1000);
+    self->last_read = self->last_write = (uint64_t)uv_now(loop->uv_loop);
+    stream_timeout_schedule(self);
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Stream_func_close(Stream *self, PyObject *args)
+{
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+    stream_timeout_clear(self);
+    return Handle_func_close((Handle *)self, args);
+}
+
+
 static PyObject *
 Stream_func_shutdown(Stream *self, PyObject *args)
 {
@@ -299,14 +480,19 @@ error:
 
 
 static PyObject *
-Stream_func_write(Stream *self, PyObject *args)
+Stream_func_write(Stream *self, PYUV_FASTCALL_PARAMS)
 {
     Py_buffer pbuf;
+    PyObject *data;
     PyObject *callback = Py_None;
 
     RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
 
-    if (!PyArg_ParseTuple(args, "s*|O:write", &pbuf, &callback)) {
+    if (!PYUV_UNPACK_ARGS("write", 1, 2, &data, &callback)) {
+        return NULL;
+    }
+
+    if (!PyArg_Parse(data, "s*:write", &pbuf)) {
         return NULL;
     }
 
@@ -437,6 +623,7 @@ static int
 Stream_tp_traverse(Stream *self, visitproc visit, void *arg)
 {
     Py_VISIT(self->on_read_cb);
+    Py_VISIT(self->on_timeout_cb);
     HandleType.tp_traverse((PyObject *)self, visit, arg);
     return 0;
 }
@@ -446,6 +633,7 @@ static int
 Stream_tp_clear(Stream *self)
 {
     Py_CLEAR(self->on_read_cb);
+    Py_CLEAR(self->on_timeout_cb);
     HandleType.tp_clear((PyObject *)self);
     return 0;
 }
@@ -454,10 +642,12 @@ Stream_tp_clear(Stream *self)
 static PyMethodDef
 Stream_tp_methods[] = {
     { "shutdown", (PyCFunction)Stream_func_shutdown, METH_VARARGS, "Shutdown the write side of this Stream." },
-    { "write", (PyCFunction)Stream_func_write, METH_VARARGS, "Write data on the stream." },
+    { "write", (PyCFunction)Stream_func_write, PYUV_METH_FASTCALL, "Write data on the stream." },
     { "writelines", (PyCFunction)Stream_func_writelines, METH_VARARGS, "Write a sequence of data on the stream." },
     { "start_read", (PyCFunction)Stream_func_start_read, METH_VARARGS, "Start read data from the connected endpoint." },
     { "stop_read", (PyCFunction)Stream_func_stop_read, METH_NOARGS, "Stop read data from the connected endpoint." },
+    { "set_timeout", (PyCFunction)Stream_func_set_timeout, METH_VARARGS|METH_KEYWORDS, "Set read and write idle timeouts." },
+    { "close", (PyCFunction)Stream_func_close, METH_VARARGS, "Close the stream." },
     { NULL }
 };
 
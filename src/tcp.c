@@ -2,7 +2,7 @@
 static void
 on_tcp_connection(uv_stream_t* server, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(server->loop);
     TCP *self;
     PyObject *result, *py_errorno;
 
@@ -21,7 +21,7 @@ on_tcp_connection(uv_stream_t* server, int status)
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(self->on_new_connection_cb, self, py_errorno, NULL);
+    result = pyuv_call2(self->on_new_connection_cb, (PyObject *)self, py_errorno);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -36,7 +36,7 @@ on_tcp_connection(uv_stream_t* server, int status)
 static void
 on_tcp_client_connection(uv_connect_t *req, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
     TCP *self;
     PyObject *callback, *result, *py_errorno;
 
@@ -56,7 +56,7 @@ on_tcp_client_connection(uv_connect_t *req, int status)
         Py_INCREF(Py_None);
     }
 
-    result = PyObject_CallFunctionObjArgs(callback, self, py_errorno, NULL);
+    result = pyuv_call2(callback, (PyObject *)self, py_errorno);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -236,6 +236,402 @@ error:
 }
 
 
+/*
+ * connect_any: race staggered connection attempts to a list of addresses and keep
+ * the first one which succeeds (RFC 6555, "Happy Eyeballs"). Attempts use their
+ * own uv_tcp_t handles, the winning one replaces the handle of the TCP object.
+ */
+
+typedef struct tcp_connect_any_s tcp_connect_any_t;
+
+typedef struct {
+    uv_tcp_t tcp_handle;    /* must be the first member: the memory is freed as a whole when the handle is closed */
+    uv_connect_t req;
+    tcp_connect_any_t *ctx;
+    Py_ssize_t index;
+} tcp_connect_attempt_t;
+
+struct tcp_connect_any_s {
+    uv_timer_t timer_handle;    /* must be the first member, see above */
+    uv_loop_t *uv_loop;
+    Loop *loop;
+    TCP *self;
+    PyObject *callback;
+    PyObject *addresses;
+    tcp_connect_attempt_t **attempts;
+    Py_ssize_t next;
+    int pending;
+    int last_error;
+    int64_t delay;
+    Bool done;
+};
+
+
+static void on_tcp_connect_any_attempt(uv_connect_t *req, int status);
+
+
+static void
+on_tcp_embedded_handle_close(uv_handle_t *handle)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    TCP *self;
+
+    ASSERT(handle);
+    self = container_of(handle, TCP, tcp_h);
+    /* refcount was increased when the handle was replaced */
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+static void
+tcp_connect_any_close_attempt(tcp_connect_attempt_t *attempt)
+{
+    attempt->ctx->attempts[attempt->index] = NULL;
+    uv_close((uv_handle_t *)&attempt->tcp_handle, on_handle_dealloc_close);
+}
+
+
+/* start a connection attempt to the next address, addresses which fail right away are skipped */
+static void
+tcp_connect_any_start_next(tcp_connect_any_t *ctx)
+{
+    int r, port, address_type;
+    char *ip;
+    Py_ssize_t index;
+    tcp_connect_attempt_t *attempt;
+
+    while (ctx->next < PyList_GET_SIZE(ctx->addresses)) {
+        index = ctx->next++;
+        /* addresses were validated in TCP_func_connect_any */
+        ip = PyBytes_AS_STRING(PyTuple_GET_ITEM(PyList_GET_ITEM(ctx->addresses, index), 0));
+        port = (int)PyInt_AsSsize_t(PyTuple_GET_ITEM(PyList_GET_ITEM(ctx->addresses, index), 1));
+        address_type = (int)PyInt_AsSsize_t(PyTuple_GET_ITEM(PyList_GET_ITEM(ctx->addresses, index), 2));
+
+        attempt = (tcp_connect_attempt_t *)PyMem_Malloc(sizeof(tcp_connect_attempt_t));
+        if (!attempt) {
+            ctx->last_error = UV_ENOMEM;
+            continue;
+        }
+
+        r = uv_tcp_init(ctx->uv_loop, &attempt->tcp_handle);
+        if (r != 0) {
+            ctx->last_error = uv_last_error(ctx->uv_loop).code;
+            PyMem_Free(attempt);
+            continue;
+        }
+        attempt->tcp_handle.data = NULL;
+        attempt->req.data = (void *)attempt;
+        attempt->ctx = ctx;
+        attempt->index = index;
+
+        if (address_type == AF_INET) {
+            r = uv_tcp_connect(&attempt->req, &attempt->tcp_handle, uv_ip4_addr(ip, port), on_tcp_connect_any_attempt);
+        } else {
+            r = uv_tcp_connect6(&attempt->req, &attempt->tcp_handle, uv_ip6_addr(ip, port), on_tcp_connect_any_attempt);
+        }
+        if (r != 0) {
+            ctx->last_error = uv_last_error(ctx->uv_loop).code;
+            uv_close((uv_handle_t *)&attempt->tcp_handle, on_handle_dealloc_close);
+            continue;
+        }
+
+        ctx->attempts[index] = attempt;
+        ctx->pending++;
+        return;
+    }
+}
+
+
+/* report the error if all attempts failed and free the context once no attempts are pending */
+static void
+tcp_connect_any_maybe_finish(tcp_connect_any_t *ctx)
+{
+    PyObject *result, *py_errorno;
+
+    if (ctx->pending > 0 || (!ctx->done && ctx->next < PyList_GET_SIZE(ctx->addresses))) {
+        return;
+    }
+
+    if (!ctx->done) {
+        ctx->done = True;
+        py_errorno = PyInt_FromLong((long)ctx->last_error);
+        result = pyuv_call2(ctx->callback, (PyObject *)ctx->self, py_errorno);
+        if (result == NULL) {
+            handle_uncaught_exception(ctx->loop);
+        }
+        Py_XDECREF(result);
+        Py_XDECREF(py_errorno);
+    }
+
+    Py_DECREF(ctx->loop);
+    Py_DECREF(ctx->self);
+    Py_DECREF(ctx->callback);
+    Py_DECREF(ctx->addresses);
+    PyMem_Free(ctx->attempts);
+    uv_close((uv_handle_t *)&ctx->timer_handle, on_handle_dealloc_close);
+}
+
+
+static void
+on_tcp_connect_any_timer(uv_timer_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    tcp_connect_any_t *ctx;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    ctx = (tcp_connect_any_t *)handle;
+
+    tcp_connect_any_start_next(ctx);
+    if (ctx->next >= PyList_GET_SIZE(ctx->addresses)) {
+        uv_timer_stop(handle);
+    }
+    tcp_connect_any_maybe_finish(ctx);
+
+    PyGILState_Release(gstate);
+}
+
+
+static void
+on_tcp_connect_any_attempt(uv_connect_t *req, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
+    Py_ssize_t i;
+    uv_handle_t *old_handle;
+    tcp_connect_attempt_t *attempt;
+    tcp_connect_any_t *ctx;
+    TCP *self;
+    PyObject *result, *py_errorno;
+
+    ASSERT(req);
+    attempt = (tcp_connect_attempt_t *)req->data;
+    ctx = attempt->ctx;
+    self = ctx->self;
+    ctx->pending--;
+
+    if (ctx->attempts[attempt->index] != attempt) {
+        /* attempt was cancelled because another one won the race */
+    } else if (status != 0) {
+        ctx->last_error = uv_last_error(ctx->uv_loop).code;
+        tcp_connect_any_close_attempt(attempt);
+        /* don't wait for the timer, try the next address right away */
+        tcp_connect_any_start_next(ctx);
+        if (ctx->next < PyList_GET_SIZE(ctx->addresses)) {
+            uv_timer_start(&ctx->timer_handle, on_tcp_connect_any_timer, ctx->delay, ctx->delay);
+        } else {
+            uv_timer_stop(&ctx->timer_handle);
+        }
+    } else {
+        ctx->done = True;
+        uv_timer_stop(&ctx->timer_handle);
+        ctx->attempts[attempt->index] = NULL;
+        for (i = 0; i < PyList_GET_SIZE(ctx->addresses); i++) {
+            if (ctx->attempts[i]) {
+                tcp_connect_any_close_attempt(ctx->attempts[i]);
+            }
+        }
+
+        /* Object could go out of scope in the callback, increase refcount to avoid it */
+        Py_INCREF(self);
+
+        if (UV_HANDLE_CLOSED(self)) {
+            uv_close((uv_handle_t *)&attempt->tcp_handle, on_handle_dealloc_close);
+            py_errorno = PyInt_FromLong((long)UV_ECANCELED);
+        } else {
+            /* the winner takes the place of the handle the object was created with */
+            old_handle = UV_HANDLE(self);
+            old_handle->data = NULL;
+            if (((Handle *)self)->uv_handle_external) {
+                uv_close(old_handle, on_handle_dealloc_close);
+            } else {
+                /* the handle lives in the object, keep it alive until libuv is done with it */
+                Py_INCREF(self);
+                uv_close(old_handle, on_tcp_embedded_handle_close);
+            }
+            attempt->tcp_handle.data = (void *)self;
+            UV_HANDLE(self) = (uv_handle_t *)&attempt->tcp_handle;
+            ((Handle *)self)->uv_handle_external = True;
+            py_errorno = Py_None;
+            Py_INCREF(Py_None);
+        }
+
+        result = pyuv_call2(ctx->callback, (PyObject *)self, py_errorno);
+        if (result == NULL) {
+            handle_uncaught_exception(ctx->loop);
+        }
+        Py_XDECREF(result);
+        Py_XDECREF(py_errorno);
+
+        Py_DECREF(self);
+    }
+
+    tcp_connect_any_maybe_finish(ctx);
+
+    PyGILState_Release(gstate);
+}
+
+
+static PyObject *
+TCP_func_connect_any(TCP *self, PyObject *args)
+{
+    int r, port, address_type, first_type;
+    char *ip;
+    double delay = 0.25;
+    Py_ssize_t i, n, i4, i6;
+    tcp_connect_any_t *ctx = NULL;
+    PyObject *addresses, *callback, *seq, *item, *ipv4, *ipv6, *ordered;
+
+    seq = ipv4 = ipv6 = ordered = NULL;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    if (!PyArg_ParseTuple(args, "OO|d:connect_any", &addresses, &callback, &delay)) {
+        return NULL;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (delay < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    seq = PySequence_Fast(addresses, "addresses must be a sequence of (ip, port) tuples");
+    if (!seq) {
+        return NULL;
+    }
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (n == 0) {
+        PyErr_SetString(PyExc_ValueError, "at least one address is required");
+        goto error;
+    }
+
+    ipv4 = PyList_New(0);
+    ipv6 = PyList_New(0);
+    ordered = PyList_New(0);
+    if (!ipv4 || !ipv6 || !ordered) {
+        goto error;
+    }
+
+    first_type = AF_INET;
+    for (i = 0; i < n; i++) {
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "si:connect_any", &ip, &port)) {
+            goto error;
+        }
+        if (port < 0 || port > 65535) {
+            PyErr_SetString(PyExc_ValueError, "port must be between 0 and 65535");
+            goto error;
+        }
+        if (pyuv_guess_ip_family(ip, &address_type)) {
+            PyErr_SetString(PyExc_ValueError, "invalid IP address");
+            goto error;
+        }
+        if (i == 0) {
+            first_type = address_type;
+        }
+        item = Py_BuildValue("(Nii)", PyBytes_FromString(ip), port, address_type);
+        if (!item) {
+            goto error;
+        }
+        r = PyList_Append((address_type == AF_INET) ? ipv4 : ipv6, item);
+        Py_DECREF(item);
+        if (r != 0) {
+            goto error;
+        }
+    }
+
+    /* interleave address families, starting with the family of the first address */
+    for (i4 = i6 = 0; i4 < PyList_GET_SIZE(ipv4) || i6 < PyList_GET_SIZE(ipv6);) {
+        if (first_type == AF_INET6 ? i6 <= i4 : i6 < i4) {
+            if (i6 < PyList_GET_SIZE(ipv6)) {
+                r = PyList_Append(ordered, PyList_GET_ITEM(ipv6, i6++));
+            } else {
+                r = PyList_Append(ordered, PyList_GET_ITEM(ipv4, i4++));
+            }
+        } else {
+            if (i4 < PyList_GET_SIZE(ipv4)) {
+                r = PyList_Append(ordered, PyList_GET_ITEM(ipv4, i4++));
+            } else {
+                r = PyList_Append(ordered, PyList_GET_ITEM(ipv6, i6++));
+            }
+        }
+        if (r != 0) {
+            goto error;
+        }
+    }
+
+    ctx = (tcp_connect_any_t *)PyMem_Malloc(sizeof(tcp_connect_any_t));
+    if (!ctx) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    ctx->attempts = (tcp_connect_attempt_t **)PyMem_Malloc(sizeof(tcp_connect_attempt_t *) * n);
+    if (!ctx->attempts) {
+        PyMem_Free(ctx);
+        PyErr_NoMemory();
+        goto error;
+    }
+    memset(ctx->attempts, 0, sizeof(tcp_connect_attempt_t *) * n);
+
+    r = uv_timer_init(UV_HANDLE_LOOP(self), &ctx->timer_handle);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_TCPError);
+        PyMem_Free(ctx->attempts);
+        PyMem_Free(ctx);
+        goto error;
+    }
+    ctx->timer_handle.data = NULL;
+
+    Py_INCREF(((Handle *)self)->loop);
+    Py_INCREF(self);
+    Py_INCREF(callback);
+    ctx->uv_loop = UV_HANDLE_LOOP(self);
+    ctx->loop = ((Handle *)self)->loop;
+    ctx->self = self;
+    ctx->callback = callback;
+    ctx->addresses = ordered;
+    ctx->next = 0;
+    ctx->pending = 0;
+    ctx->last_error = UV_OK;
+    ctx->delay = (int64_t)(delay * 1000);
+    ctx->done = False;
+
+    tcp_connect_any_start_next(ctx);
+    if (ctx->pending == 0) {
+        /* no attempt could be started */
+        RAISE_UV_EXCEPTION(ctx->uv_loop, PyExc_TCPError);
+        ctx->done = True;
+        tcp_connect_any_maybe_finish(ctx);
+        Py_DECREF(seq);
+        Py_DECREF(ipv4);
+        Py_DECREF(ipv6);
+        return NULL;
+    }
+
+    if (ctx->next < PyList_GET_SIZE(ctx->addresses)) {
+        uv_timer_start(&ctx->timer_handle, on_tcp_connect_any_timer, ctx->delay, ctx->delay);
+    }
+
+    Py_DECREF(seq);
+    Py_DECREF(ipv4);
+    Py_DECREF(ipv6);
+    Py_RETURN_NONE;
+
+error:
+    Py_XDECREF(seq);
+    Py_XDECREF(ipv4);
+    Py_XDECREF(ipv6);
+    Py_XDECREF(ordered);
+    return NULL;
+}
+
+
 static PyObject *
 TCP_func_getsockname(TCP *self)
 {
@@ -390,6 +786,14 @@ TCP_func_open(TCP *self, PyObject *args)
 }
 
 
+static PyObject *
+TCP_func_get_info(TCP *self)
+{
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+    return pyuv_tcp_get_info((uv_tcp_t *)UV_HANDLE(self));
+}
+
+
 static int
 TCP_tp_init(TCP *self, PyObject *args, PyObject *kwargs)
 {
@@ -414,12 +818,7 @@ TCP_tp_init(TCP *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_tcp = PyMem_Malloc(sizeof(uv_tcp_t));
-    if (!uv_tcp) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_tcp = &self->tcp_h;
 
     r = uv_tcp_init(UV_HANDLE_LOOP(self), (uv_tcp_t *)uv_tcp);
     if (r != 0) {
@@ -441,6 +840,7 @@ TCP_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
     if (!self) {
         return NULL;
     }
+    self->pool = NULL;
     return (PyObject *)self;
 }
 
@@ -469,12 +869,14 @@ TCP_tp_methods[] = {
     { "listen", (PyCFunction)TCP_func_listen, METH_VARARGS, "Start listening for TCP connections." },
     { "accept", (PyCFunction)TCP_func_accept, METH_VARARGS, "Accept incoming connection." },
     { "connect", (PyCFunction)TCP_func_connect, METH_VARARGS, "Start connecion to remote endpoint." },
+    { "connect_any", (PyCFunction)TCP_func_connect_any, METH_VARARGS, "Race staggered connection attempts to the given endpoints and keep the first one which succeeds." },
     { "getsockname", (PyCFunction)TCP_func_getsockname, METH_NOARGS, "Get local socket information." },
     { "getpeername", (PyCFunction)TCP_func_getpeername, METH_NOARGS, "Get remote socket information." },
     { "nodelay", (PyCFunction)TCP_func_nodelay, METH_VARARGS, "Enable/disable Nagle's algorithm." },
     { "keepalive", (PyCFunction)TCP_func_keepalive, METH_VARARGS, "Enable/disable TCP keep-alive." },
     { "open", (PyCFunction)TCP_func_open, METH_VARARGS, "Open the specified file descriptor and manage it as a TCP handle." },
     { "simultaneous_accepts", (PyCFunction)TCP_func_simultaneous_accepts, METH_VARARGS, "Enable/disable simultaneous asynchronous accept requests that are queued by the operating system when listening for new tcp connections." },
+    { "get_info", (PyCFunction)TCP_func_get_info, METH_NOARGS, "Get kernel statistics (TCP_INFO) for this connection." },
     { NULL }
 };
 
@@ -0,0 +1,988 @@
+
+/*
+ * TCPPool keeps connected TCP handles around so that they can be reused for
+ * subsequent requests to the same remote endpoint. State is kept per host in
+ * a TCPPoolHost object: idle is a list of (handle, timestamp) tuples (most
+ * recently released last), waiters is a list of callbacks waiting for a free
+ * slot and count is the number of connections owned by the pool for that host
+ * (connecting, in use or idle).
+ */
+
+#define RAISE_IF_TCPPOOL_CLOSED(obj)                                        \
+    do {                                                                    \
+        if ((obj)->closed) {                                                \
+            PyErr_SetString(PyExc_TCPPoolError, "TCPPool is closed");       \
+            return NULL;                                                    \
+        }                                                                   \
+    } while(0)                                                              \
+
+
+typedef struct {
+    TCPPool *pool;
+    PyObject *callback;
+} tcppool_connect_data_t;
+
+
+static int tcppool_acquire(TCPPool *self, PyObject *key, PyObject *callback);
+static void tcppool_dispatch(TCPPool *self, PyObject *key);
+
+
+static TCPPoolHost *
+tcppool_get_host(TCPPool *self, PyObject *key)
+{
+    TCPPoolHost *host;
+
+    host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+    if (host) {
+        return host;
+    }
+
+    host = PyObject_GC_New(TCPPoolHost, &TCPPoolHostType);
+    if (!host) {
+        return NULL;
+    }
+    host->idle = PyList_New(0);
+    host->waiters = PyList_New(0);
+    host->count = 0;
+    PyObject_GC_Track(host);
+    if (!host->idle || !host->waiters || PyDict_SetItem(self->hosts, key, (PyObject *)host) != 0) {
+        Py_DECREF(host);
+        return NULL;
+    }
+    Py_DECREF(host);
+    return host;
+}
+
+
+static void
+tcppool_call(TCPPool *self, PyObject *callback, PyObject *handle, PyObject *error)
+{
+    PyObject *result;
+
+    result = pyuv_call3(callback, (PyObject *)self, handle, error);
+    if (result == NULL) {
+        handle_uncaught_exception(self->loop);
+    }
+    Py_XDECREF(result);
+}
+
+
+static void
+tcppool_close_handle(PyObject *handle)
+{
+    PyObject *result;
+
+    if (UV_HANDLE_CLOSED(handle)) {
+        return;
+    }
+    result = PyObject_CallMethod(handle, "close", NULL);
+    if (result == NULL) {
+        print_uncaught_exception();
+    }
+    Py_XDECREF(result);
+}
+
+
+/* remove the host entry once it has no connections and nobody is waiting for one */
+static int
+tcppool_drop_host(TCPPool *self, PyObject *key)
+{
+    TCPPoolHost *host;
+
+    host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+    if (host && host->count <= 0 && PyList_GET_SIZE(host->waiters) == 0) {
+        return PyDict_DelItem(self->hosts, key);
+    }
+    return 0;
+}
+
+
+/* drop a connection from the pool and close it, the slot it was using is freed */
+static void
+tcppool_forget(TCPPool *self, PyObject *handle)
+{
+    PyObject *key;
+    TCPPoolHost *host;
+
+    key = PyDict_GetItem(self->handles, handle);
+    if (!key) {
+        return;
+    }
+    Py_INCREF(key);
+    Py_INCREF(handle);
+
+    ((TCP *)handle)->pool = NULL;
+    if (PyDict_DelItem(self->handles, handle) != 0) {
+        print_uncaught_exception();
+    }
+    tcppool_close_handle(handle);
+
+    host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+    if (host) {
+        host->count--;
+        if (tcppool_drop_host(self, key) != 0) {
+            print_uncaught_exception();
+        }
+    }
+
+    Py_DECREF(handle);
+    Py_DECREF(key);
+}
+
+
+static void
+on_tcppool_client_connection(uv_connect_t *req, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
+    TCPPool *self;
+    PyObject *handle, *key, *callback, *py_errorno;
+    tcppool_connect_data_t *req_data;
+
+    ASSERT(req);
+    req_data = (tcppool_connect_data_t *)req->data;
+    handle = (PyObject *)req->handle->data;
+    self = req_data->pool;
+    callback = req_data->callback;
+
+    ASSERT(self);
+    ASSERT(handle);
+    /* Object could go out of scope in the callback, increase refcount to avoid it */
+    Py_INCREF(handle);
+
+    if (status != 0) {
+        uv_err_t err = uv_last_error(UV_HANDLE_LOOP(handle));
+        py_errorno = PyInt_FromLong((long)err.code);
+        key = PyDict_GetItem(self->handles, handle);
+        Py_XINCREF(key);
+        tcppool_forget(self, handle);
+        tcppool_call(self, callback, Py_None, py_errorno);
+        Py_DECREF(py_errorno);
+        if (key) {
+            tcppool_dispatch(self, key);
+            Py_DECREF(key);
+        }
+    } else {
+        tcppool_call(self, callback, handle, Py_None);
+    }
+
+    Py_DECREF(callback);
+    Py_DECREF(self);
+    PyMem_Free(req_data);
+    PyMem_Free(req);
+
+    Py_DECREF(handle);
+    PyGILState_Release(gstate);
+}
+
+
+/* start a new connection for the given host, the callback is called when it's established */
+static int
+tcppool_connect(TCPPool *self, PyObject *key, PyObject *callback)
+{
+    int r, port, address_type;
+    char *ip;
+    uv_connect_t *connect_req = NULL;
+    tcppool_connect_data_t *req_data = NULL;
+    PyObject *handle = NULL;
+    PyObject *exc_type, *exc_value, *exc_tb;
+    TCPPoolHost *host;
+
+    if (!PyArg_ParseTuple(key, "si", &ip, &port)) {
+        return -1;
+    }
+
+    if (pyuv_guess_ip_family(ip, &address_type)) {
+        PyErr_SetString(PyExc_ValueError, "invalid IP address");
+        return -1;
+    }
+
+    host = tcppool_get_host(self, key);
+    if (!host) {
+        return -1;
+    }
+
+    handle = pyuv_call1((PyObject *)&TCPType, (PyObject *)self->loop);
+    if (!handle) {
+        goto error;
+    }
+
+    connect_req = (uv_connect_t *)PyMem_Malloc(sizeof(uv_connect_t));
+    req_data = (tcppool_connect_data_t *)PyMem_Malloc(sizeof(tcppool_connect_data_t));
+    if (!connect_req || !req_data) {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    req_data->pool = self;
+    req_data->callback = callback;
+    connect_req->data = (void *)req_data;
+
+    /* the handle must be known before the request is started, so that its slot can be freed */
+    if (PyDict_SetItem(self->handles, handle, key) != 0) {
+        goto error;
+    }
+
+    if (address_type == AF_INET) {
+        r = uv_tcp_connect(connect_req, (uv_tcp_t *)UV_HANDLE(handle), uv_ip4_addr(ip, port), on_tcppool_client_connection);
+    } else {
+        r = uv_tcp_connect6(connect_req, (uv_tcp_t *)UV_HANDLE(handle), uv_ip6_addr(ip, port), on_tcppool_client_connection);
+    }
+
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_TCPPoolError);
+        PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+        if (PyDict_DelItem(self->handles, handle) != 0) {
+            print_uncaught_exception();
+        }
+        PyErr_Restore(exc_type, exc_value, exc_tb);
+        goto error;
+    }
+
+    host->count++;
+
+    Py_INCREF(self);
+    Py_INCREF(callback);
+    Py_DECREF(handle);
+    return 0;
+
+error:
+    if (connect_req) {
+        PyMem_Free(connect_req);
+    }
+    if (req_data) {
+        PyMem_Free(req_data);
+    }
+    PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    if (handle) {
+        tcppool_close_handle(handle);
+        Py_DECREF(handle);
+    }
+    /* the host entry may have been created for this connection */
+    if (tcppool_drop_host(self, key) != 0) {
+        print_uncaught_exception();
+    }
+    PyErr_Restore(exc_type, exc_value, exc_tb);
+    return -1;
+}
+
+
+/* take the most recently used idle connection for the given host, if any */
+static PyObject *
+tcppool_take_idle(TCPPool *self, TCPPoolHost *host)
+{
+    Py_ssize_t n;
+    PyObject *idle, *item, *handle;
+
+    /* tcppool_forget may drop the host entry, keep it alive while we look */
+    Py_INCREF(host);
+    idle = host->idle;
+    while ((n = PyList_GET_SIZE(idle)) > 0) {
+        item = PyList_GET_ITEM(idle, n - 1);
+        handle = PyTuple_GET_ITEM(item, 0);
+        Py_INCREF(handle);
+        PyList_SetSlice(idle, n - 1, n, NULL);
+        self->idle_count--;
+
+        if (UV_HANDLE_CLOSED(handle) || !uv_is_readable((uv_stream_t *)UV_HANDLE(handle)) || !uv_is_writable((uv_stream_t *)UV_HANDLE(handle))) {
+            tcppool_forget(self, handle);
+            Py_DECREF(handle);
+            continue;
+        }
+
+        uv_read_stop((uv_stream_t *)UV_HANDLE(handle));
+        uv_ref(UV_HANDLE(handle));
+        ((TCP *)handle)->pool = NULL;
+
+        if (self->idle_count == 0 && self->timer_handle) {
+            uv_timer_stop(self->timer_handle);
+        }
+        Py_DECREF(host);
+        return handle;
+    }
+
+    Py_DECREF(host);
+    return NULL;
+}
+
+
+/* drop the connections to the given host which were closed without being released */
+static void
+tcppool_reap(TCPPool *self, PyObject *key)
+{
+    int r;
+    Py_ssize_t i, pos = 0;
+    PyObject *closed, *handle, *value;
+
+    closed = PyList_New(0);
+    if (!closed) {
+        print_uncaught_exception();
+        return;
+    }
+
+    while (PyDict_Next(self->handles, &pos, &handle, &value)) {
+        if (UV_HANDLE_CLOSED(handle)) {
+            r = PyObject_RichCompareBool(value, key, Py_EQ);
+            if (r == 1) {
+                r = PyList_Append(closed, handle);
+            }
+            if (r == -1) {
+                /* the handles found so far are still reclaimed */
+                print_uncaught_exception();
+                break;
+            }
+        }
+    }
+
+    for (i = 0; i < PyList_GET_SIZE(closed); i++) {
+        tcppool_forget(self, PyList_GET_ITEM(closed, i));
+    }
+
+    Py_DECREF(closed);
+}
+
+
+static int
+tcppool_acquire(TCPPool *self, PyObject *key, PyObject *callback)
+{
+    PyObject *handle;
+    TCPPoolHost *host;
+
+    host = tcppool_get_host(self, key);
+    if (!host) {
+        return -1;
+    }
+
+    handle = tcppool_take_idle(self, host);
+    if (handle) {
+        tcppool_call(self, callback, handle, Py_None);
+        Py_DECREF(handle);
+        return 0;
+    }
+
+    /* tcppool_take_idle may have dropped the host entry */
+    host = tcppool_get_host(self, key);
+    if (!host) {
+        return -1;
+    }
+
+    if (host->count < (Py_ssize_t)self->max_per_host) {
+        return tcppool_connect(self, key, callback);
+    }
+
+    /* the dispatcher reclaims the slots of handles which were closed without being released */
+    if (PyList_Append(host->waiters, callback) != 0) {
+        return -1;
+    }
+    tcppool_dispatch(self, key);
+    return 0;
+}
+
+
+/* a slot was freed for the given host, hand it to the next waiter */
+static void
+tcppool_dispatch(TCPPool *self, PyObject *key)
+{
+    Bool reaped = False;
+    PyObject *waiters, *callback;
+    TCPPoolHost *host;
+
+    Py_INCREF(key);
+    while (1) {
+        host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+        if (!host) {
+            break;
+        }
+        waiters = host->waiters;
+        if (PyList_GET_SIZE(waiters) == 0) {
+            break;
+        }
+        if (PyList_GET_SIZE(host->idle) == 0 && host->count >= (Py_ssize_t)self->max_per_host) {
+            if (reaped) {
+                break;
+            }
+            tcppool_reap(self, key);
+            reaped = True;
+            continue;
+        }
+        callback = PyList_GET_ITEM(waiters, 0);
+        Py_INCREF(callback);
+        PyList_SetSlice(waiters, 0, 1, NULL);
+        if (tcppool_acquire(self, key, callback) != 0) {
+            handle_uncaught_exception(self->loop);
+        }
+        Py_DECREF(callback);
+    }
+    Py_DECREF(key);
+}
+
+
+/* an idle connection was closed by the peer, got unexpected data or failed */
+static void
+on_tcppool_idle_read(uv_stream_t* handle, int nread, uv_buf_t buf)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    Py_ssize_t i;
+    TCP *tcp;
+    TCPPool *self;
+    TCPPoolHost *host;
+    PyObject *key, *idle;
+
+    ASSERT(handle);
+    UNUSED_ARG(buf);
+
+    tcp = (TCP *)handle->data;
+    ASSERT(tcp);
+    self = tcp->pool;
+
+    /* nothing was actually read */
+    if (nread == 0) {
+        goto done;
+    }
+
+    key = self ? PyDict_GetItem(self->handles, (PyObject *)tcp) : NULL;
+    if (!key) {
+        /* the pool is gone */
+        uv_read_stop(handle);
+        goto done;
+    }
+
+    Py_INCREF(self);
+    Py_INCREF(tcp);
+    Py_INCREF(key);
+
+    host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+    if (host) {
+        idle = host->idle;
+        for (i = 0; i < PyList_GET_SIZE(idle); i++) {
+            if (PyTuple_GET_ITEM(PyList_GET_ITEM(idle, i), 0) == (PyObject *)tcp) {
+                PyList_SetSlice(idle, i, i + 1, NULL);
+                self->idle_count--;
+                break;
+            }
+        }
+    }
+
+    tcppool_forget(self, (PyObject *)tcp);
+    tcppool_dispatch(self, key);
+
+    if (self->idle_count == 0 && self->timer_handle) {
+        uv_timer_stop(self->timer_handle);
+    }
+
+    Py_DECREF(key);
+    Py_DECREF(tcp);
+    Py_DECREF(self);
+
+done:
+    PyGILState_Release(gstate);
+}
+
+
+static void
+on_tcppool_timer(uv_timer_t *handle, int status)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
+    Py_ssize_t i, n, expired;
+    double now;
+    TCPPool *self;
+    TCPPoolHost *host;
+    PyObject *keys, *key, *idle, *item, *handle_obj;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    self = (TCPPool *)handle->data;
+    ASSERT(self);
+    Py_INCREF(self);
+
+    now = uv_now(UV_LOOP(self)) / 1000.0;
+
+    keys = PyDict_Keys(self->hosts);
+    if (!keys) {
+        handle_uncaught_exception(self->loop);
+        goto done;
+    }
+
+    for (i = 0; i < PyList_GET_SIZE(keys); i++) {
+        key = PyList_GET_ITEM(keys, i);
+        host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+        if (!host) {
+            continue;
+        }
+        Py_INCREF(host);
+        idle = host->idle;
+        /* idle connections are kept in release order, so expired ones are at the front */
+        for (expired = 0, n = PyList_GET_SIZE(idle); expired < n; expired++) {
+            item = PyList_GET_ITEM(idle, expired);
+            if (PyFloat_AS_DOUBLE(PyTuple_GET_ITEM(item, 1)) + self->idle_timeout > now) {
+                break;
+            }
+        }
+        while (expired-- > 0) {
+            handle_obj = PyTuple_GET_ITEM(PyList_GET_ITEM(idle, 0), 0);
+            Py_INCREF(handle_obj);
+            PyList_SetSlice(idle, 0, 1, NULL);
+            self->idle_count--;
+            tcppool_forget(self, handle_obj);
+            Py_DECREF(handle_obj);
+        }
+        Py_DECREF(host);
+    }
+    Py_DECREF(keys);
+
+    if (self->idle_count == 0) {
+        uv_timer_stop(handle);
+    }
+
+done:
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+static PyObject *
+TCPPool_func_acquire(TCPPool *self, PyObject *args)
+{
+    int port, address_type;
+    char *ip;
+    PyObject *key, *callback;
+
+    RAISE_IF_TCPPOOL_CLOSED(self);
+
+    if (!PyArg_ParseTuple(args, "(si)O:acquire", &ip, &port, &callback)) {
+        return NULL;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (port < 0 || port > 65535) {
+        PyErr_SetString(PyExc_ValueError, "port must be between 0 and 65535");
+        return NULL;
+    }
+
+    if (pyuv_guess_ip_family(ip, &address_type)) {
+        PyErr_SetString(PyExc_ValueError, "invalid IP address");
+        return NULL;
+    }
+
+    key = Py_BuildValue("(si)", ip, port);
+    if (!key) {
+        return NULL;
+    }
+
+    if (tcppool_acquire(self, key, callback) != 0) {
+        Py_DECREF(key);
+        return NULL;
+    }
+
+    Py_DECREF(key);
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+TCPPool_func_release(TCPPool *self, PyObject *args)
+{
+    int r;
+    PyObject *handle, *key, *waiters, *callback, *item;
+    TCPPoolHost *host;
+
+    if (!PyArg_ParseTuple(args, "O!:release", &TCPType, &handle)) {
+        return NULL;
+    }
+
+    key = PyDict_GetItem(self->handles, handle);
+    if (!key) {
+        PyErr_SetString(PyExc_ValueError, "handle does not belong to this pool");
+        return NULL;
+    }
+    Py_INCREF(key);
+
+    if (self->closed || UV_HANDLE_CLOSED(handle) || !uv_is_readable((uv_stream_t *)UV_HANDLE(handle)) || !uv_is_writable((uv_stream_t *)UV_HANDLE(handle))) {
+        tcppool_forget(self, handle);
+        tcppool_dispatch(self, key);
+        goto done;
+    }
+
+    host = tcppool_get_host(self, key);
+    if (!host) {
+        Py_DECREF(key);
+        return NULL;
+    }
+
+    /* somebody is waiting for a connection to this host, hand it over directly */
+    waiters = host->waiters;
+    if (PyList_GET_SIZE(waiters) > 0) {
+        callback = PyList_GET_ITEM(waiters, 0);
+        Py_INCREF(callback);
+        PyList_SetSlice(waiters, 0, 1, NULL);
+        tcppool_call(self, callback, handle, Py_None);
+        Py_DECREF(callback);
+        goto done;
+    }
+
+    /* watch the idle connection so that we notice if the peer closes it */
+    Py_CLEAR(((Stream *)handle)->on_read_cb);
+    r = uv_read_start((uv_stream_t *)UV_HANDLE(handle), (uv_alloc_cb)on_stream_alloc, (uv_read_cb)on_tcppool_idle_read);
+    if (r != 0) {
+        tcppool_forget(self, handle);
+        tcppool_dispatch(self, key);
+        goto done;
+    }
+    uv_unref(UV_HANDLE(handle));
+    ((TCP *)handle)->pool = self;
+
+    item = Py_BuildValue("(Od)", handle, uv_now(UV_LOOP(self)) / 1000.0);
+    if (!item || PyList_Append(host->idle, item) != 0) {
+        Py_XDECREF(item);
+        Py_DECREF(key);
+        return NULL;
+    }
+    Py_DECREF(item);
+
+    if (self->idle_count++ == 0 && self->idle_timeout > 0.0) {
+        uv_timer_start(self->timer_handle, on_tcppool_timer, self->sweep_interval, self->sweep_interval);
+    }
+
+done:
+    Py_DECREF(key);
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+TCPPool_func_close(TCPPool *self)
+{
+    Py_ssize_t i, j;
+    PyObject *keys, *key, *idle, *waiters, *handle, *py_errorno;
+    TCPPoolHost *host;
+
+    RAISE_IF_TCPPOOL_CLOSED(self);
+
+    self->closed = True;
+
+    keys = PyDict_Keys(self->hosts);
+    if (!keys) {
+        return NULL;
+    }
+
+    py_errorno = PyInt_FromLong((long)UV_ECANCELED);
+
+    for (i = 0; i < PyList_GET_SIZE(keys); i++) {
+        key = PyList_GET_ITEM(keys, i);
+        host = (TCPPoolHost *)PyDict_GetItem(self->hosts, key);
+        if (!host) {
+            continue;
+        }
+        Py_INCREF(host);
+
+        waiters = PyList_GetSlice(host->waiters, 0, PyList_GET_SIZE(host->waiters));
+        if (!waiters) {
+            PyErr_Clear();
+            Py_DECREF(host);
+            continue;
+        }
+        PyList_SetSlice(host->waiters, 0, PyList_GET_SIZE(host->waiters), NULL);
+        for (j = 0; j < PyList_GET_SIZE(waiters); j++) {
+            tcppool_call(self, PyList_GET_ITEM(waiters, j), Py_None, py_errorno);
+        }
+        Py_DECREF(waiters);
+
+        idle = host->idle;
+        while (PyList_GET_SIZE(idle) > 0) {
+            handle = PyTuple_GET_ITEM(PyList_GET_ITEM(idle, 0), 0);
+            Py_INCREF(handle);
+            PyList_SetSlice(idle, 0, 1, NULL);
+            self->idle_count--;
+            tcppool_forget(self, handle);
+            Py_DECREF(handle);
+        }
+
+        Py_DECREF(host);
+    }
+
+    Py_DECREF(py_errorno);
+    Py_DECREF(keys);
+
+    if (self->timer_handle) {
+        uv_close((uv_handle_t *)self->timer_handle, on_handle_dealloc_close);
+        self->timer_handle = NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+TCPPool_idle_get(TCPPool *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyInt_FromSsize_t(self->idle_count);
+}
+
+
+static PyObject *
+TCPPool_closed_get(TCPPool *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyBool_FromLong((long)self->closed);
+}
+
+
+static int
+TCPPool_tp_init(TCPPool *self, PyObject *args, PyObject *kwargs)
+{
+    int r;
+    unsigned int max_per_host = 8;
+    double idle_timeout = 60.0;
+    uv_timer_t *uv_timer = NULL;
+    Loop *loop;
+    PyObject *tmp = NULL;
+
+    static char *kwlist[] = {"loop", "max_per_host", "idle_timeout", NULL};
+
+    if (self->timer_handle) {
+        PyErr_SetString(PyExc_TCPPoolError, "Object already initialized");
+        return -1;
+    }
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|Id:__init__", kwlist, &LoopType, &loop, &max_per_host, &idle_timeout)) {
+        return -1;
+    }
+
+    if (max_per_host == 0) {
+        PyErr_SetString(PyExc_ValueError, "max_per_host must be bigger than 0");
+        return -1;
+    }
+
+    if (idle_timeout < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return -1;
+    }
+
+    tmp = (PyObject *)self->loop;
+    Py_INCREF(loop);
+    self->loop = loop;
+    Py_XDECREF(tmp);
+
+    self->hosts = PyDict_New();
+    self->handles = PyDict_New();
+    if (!self->hosts || !self->handles) {
+        goto error;
+    }
+
+    uv_timer = PyMem_Malloc(sizeof(uv_timer_t));
+    if (!uv_timer) {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    r = uv_timer_init(UV_LOOP(self), uv_timer);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_LOOP(self), PyExc_TCPPoolError);
+        PyMem_Free(uv_timer);
+        goto error;
+    }
+    /* the sweeper must not keep the loop alive */
+    uv_unref((uv_handle_t *)uv_timer);
+    uv_timer->data = (void *)self;
+    self->timer_handle = uv_timer;
+
+    self->max_per_host = max_per_host;
+    self->idle_timeout = idle_timeout;
+    /* idle connections are checked twice per timeout period */
+    self->sweep_interval = (int64_t)(idle_timeout * 1000 / 2);
+    if (self->sweep_interval < 1) {
+        self->sweep_interval = 1;
+    }
+
+    return 0;
+
+error:
+    Py_CLEAR(self->hosts);
+    Py_CLEAR(self->handles);
+    Py_CLEAR(self->loop);
+    return -1;
+}
+
+
+static PyObject *
+TCPPool_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    TCPPool *self = (TCPPool *)PyType_GenericNew(type, args, kwargs);
+    if (!self) {
+        return NULL;
+    }
+    self->timer_handle = NULL;
+    self->idle_count = 0;
+    self->closed = False;
+    return (PyObject *)self;
+}
+
+
+static int
+TCPPool_tp_traverse(TCPPool *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->loop);
+    Py_VISIT(self->hosts);
+    Py_VISIT(self->handles);
+    return 0;
+}
+
+
+static int
+TCPPool_tp_clear(TCPPool *self)
+{
+    Py_ssize_t pos = 0;
+    PyObject *handle, *key;
+
+    /* idle handles may outlive the pool, they must not point to it */
+    if (self->handles) {
+        while (PyDict_Next(self->handles, &pos, &handle, &key)) {
+            if (((TCP *)handle)->pool == self) {
+                ((TCP *)handle)->pool = NULL;
+            }
+        }
+    }
+
+    Py_CLEAR(self->loop);
+    Py_CLEAR(self->hosts);
+    Py_CLEAR(self->handles);
+    return 0;
+}
+
+
+static void
+TCPPool_tp_dealloc(TCPPool *self)
+{
+    if (self->timer_handle) {
+        uv_close((uv_handle_t *)self->timer_handle, on_handle_dealloc_close);
+    }
+    Py_TYPE(self)->tp_clear((PyObject *)self);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+
+static PyMethodDef
+TCPPool_tp_methods[] = {
+    { "acquire", (PyCFunction)TCPPool_func_acquire, METH_VARARGS, "Get a connected TCP handle for the given remote endpoint." },
+    { "release", (PyCFunction)TCPPool_func_release, METH_VARARGS, "Give a TCP handle back to the pool." },
+    { "close", (PyCFunction)TCPPool_func_close, METH_NOARGS, "Close all idle connections and stop the pool." },
+    { NULL }
+};
+
+
+static PyMemberDef TCPPool_tp_members[] = {
+    {"loop", T_OBJECT_EX, offsetof(TCPPool, loop), READONLY, "Loop where this TCPPool is running on."},
+    {"max_per_host", T_UINT, offsetof(TCPPool, max_per_host), READONLY, "Maximum number of connections per remote endpoint."},
+    {"idle_timeout", T_DOUBLE, offsetof(TCPPool, idle_timeout), READONLY, "Time after which idle connections are closed."},
+    {NULL}
+};
+
+
+static PyGetSetDef TCPPool_tp_getsets[] = {
+    {"idle", (getter)TCPPool_idle_get, NULL, "Number of idle connections kept by the pool.", NULL},
+    {"closed", (getter)TCPPool_closed_get, NULL, "Indicates if the pool is closed.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject TCPPoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.TCPPool",                                                 /*tp_name*/
+    sizeof(TCPPool),                                                /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)TCPPool_tp_dealloc,                                 /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)TCPPool_tp_traverse,                              /*tp_traverse*/
+    (inquiry)TCPPool_tp_clear,                                      /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    TCPPool_tp_methods,                                             /*tp_methods*/
+    TCPPool_tp_members,                                             /*tp_members*/
+    TCPPool_tp_getsets,                                             /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    (initproc)TCPPool_tp_init,                                      /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    TCPPool_tp_new,                                                 /*tp_new*/
+};
+
+
+
+static int
+TCPPoolHost_tp_traverse(TCPPoolHost *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->idle);
+    Py_VISIT(self->waiters);
+    return 0;
+}
+
+
+static int
+TCPPoolHost_tp_clear(TCPPoolHost *self)
+{
+    Py_CLEAR(self->idle);
+    Py_CLEAR(self->waiters);
+    return 0;
+}
+
+
+static void
+TCPPoolHost_tp_dealloc(TCPPoolHost *self)
+{
+    PyObject_GC_UnTrack(self);
+    TCPPoolHost_tp_clear(self);
+    PyObject_GC_Del(self);
+}
+
+
+static PyTypeObject TCPPoolHostType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv._TCPPoolHost",                                            /*tp_name*/
+    sizeof(TCPPoolHost),                                            /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)TCPPoolHost_tp_dealloc,                             /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)TCPPoolHost_tp_traverse,                          /*tp_traverse*/
+    (inquiry)TCPPoolHost_tp_clear,                                  /*tp_clear*/
+};
+
@@ -62,16 +62,19 @@ threadpool_work_cb(uv_work_t *req)
 static void
 threadpool_after_work_cb(uv_work_t *req)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     tpool_req_data_t *data;
     PyObject *result;
+    uint64_t start;
 
     ASSERT(req);
 
     data = (tpool_req_data_t*)req->data;
 
     if (data->after_work_cb) {
-        result = PyObject_CallFunctionObjArgs(data->after_work_cb, data->result, data->error, NULL);
+        start = pyuv_metrics_start(req->loop);
+        result = pyuv_call2(data->after_work_cb, data->result, data->error);
+        pyuv_metrics_end(req->loop, PYUV_METRIC_THREADPOOL, start, (PyObject *)req->loop->data, data->after_work_cb);
         if (result == NULL) {
             print_uncaught_exception();
         }
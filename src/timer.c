@@ -2,9 +2,10 @@
 static void
 on_timer_callback(uv_timer_t *timer, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(timer->loop);
     Timer *self;
     PyObject *result;
+    uint64_t start;
 
     ASSERT(timer);
     ASSERT(status == 0);
@@ -14,7 +15,9 @@ on_timer_callback(uv_timer_t *timer, int status)
     /* Object could go out of scope in the callback, increase refcount to avoid it */
     Py_INCREF(self);
 
-    result = PyObject_CallFunctionObjArgs(self->callback, self, NULL);
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call1(self->callback, (PyObject *)self);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_TIMER, start, (PyObject *)self, self->callback);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -25,27 +28,78 @@ on_timer_callback(uv_timer_t *timer, int status)
 }
 
 
+/* libuv timers have millisecond resolution, nanosecond values are rounded up so they never fire early */
+#define NS_TO_MS(ns) (int64_t)((ns) / 1000000 + ((ns) % 1000000 != 0))
+
+
 static PyObject *
-Timer_func_start(Timer *self, PyObject *args, PyObject *kwargs)
+pyuv_timer_start(Timer *self, PyObject *callback, int64_t timeout, int64_t repeat)
 {
     int r;
+    uint64_t now, due;
+    PyObject *tmp;
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    /* round the expiration time up to a multiple of the slack, so timers which expire
+     * close to each other do it in the same loop iteration */
+    if (self->slack > 0) {
+        now = (uint64_t)uv_now(UV_HANDLE_LOOP(self));
+        due = now + (uint64_t)timeout;
+        due = ((due + self->slack - 1) / self->slack) * self->slack;
+        timeout = (int64_t)(due - now);
+    }
+
+    r = uv_timer_start((uv_timer_t *)UV_HANDLE(self), on_timer_callback, timeout, repeat);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_TimerError);
+        return NULL;
+    }
+
+    tmp = self->callback;
+    Py_INCREF(callback);
+    self->callback = callback;
+    Py_XDECREF(tmp);
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Timer_func_start(Timer *self, PYUV_FASTCALL_KEYWORDS_PARAMS)
+{
     double timeout, repeat;
-    PyObject *tmp, *callback;
+    PyObject *callback;
+#ifdef PYUV_HAVE_FASTCALL
+    PyObject *py_timeout, *py_repeat;
+#endif
 
     static char *kwlist[] = {"callback", "timeout", "repeat", NULL};
 
-    tmp = NULL;
-
     RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Odd:__init__", kwlist, &callback, &timeout, &repeat)) {
+#ifdef PYUV_HAVE_FASTCALL
+    if (!pyuv_unpack_stack_keywords(args, nargs, kwnames, "start", kwlist, 3, &callback, &py_timeout, &py_repeat)) {
         return NULL;
     }
 
-    if (!PyCallable_Check(callback)) {
-        PyErr_SetString(PyExc_TypeError, "a callable is required");
+    timeout = PyFloat_AsDouble(py_timeout);
+    if (timeout == -1.0 && PyErr_Occurred()) {
+        return NULL;
+    }
+
+    repeat = PyFloat_AsDouble(py_repeat);
+    if (repeat == -1.0 && PyErr_Occurred()) {
+        return NULL;
+    }
+#else
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Odd:__init__", kwlist, &callback, &timeout, &repeat)) {
         return NULL;
     }
+#endif
 
     if (timeout < 0.0) {
         PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
@@ -57,18 +111,30 @@ Timer_func_start(Timer *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
-    r = uv_timer_start((uv_timer_t *)UV_HANDLE(self), on_timer_callback, (int64_t)(timeout * 1000), (int64_t)(repeat * 1000));
-    if (r != 0) {
-        RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_TimerError);
+    return pyuv_timer_start(self, callback, (int64_t)(timeout * 1000), (int64_t)(repeat * 1000));
+}
+
+
+static PyObject *
+Timer_func_start_ns(Timer *self, PyObject *args, PyObject *kwargs)
+{
+    PY_LONG_LONG timeout, repeat;
+    PyObject *callback;
+
+    static char *kwlist[] = {"callback", "timeout", "repeat", NULL};
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OLL:start_ns", kwlist, &callback, &timeout, &repeat)) {
         return NULL;
     }
 
-    tmp = self->callback;
-    Py_INCREF(callback);
-    self->callback = callback;
-    Py_XDECREF(tmp);
+    if (timeout < 0 || repeat < 0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
 
-    Py_RETURN_NONE;
+    return pyuv_timer_start(self, callback, NS_TO_MS(timeout), NS_TO_MS(repeat));
 }
 
 
@@ -145,6 +211,81 @@ Timer_repeat_set(Timer *self, PyObject *value, void *closure)
 }
 
 
+static PyObject *
+Timer_repeat_ns_get(Timer *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)uv_timer_get_repeat((uv_timer_t *)UV_HANDLE(self)) * 1000000);
+}
+
+
+static int
+Timer_repeat_ns_set(Timer *self, PyObject *value, void *closure)
+{
+    PY_LONG_LONG repeat;
+
+    UNUSED_ARG(closure);
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, -1);
+
+    if (!value) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete attribute");
+        return -1;
+    }
+
+    repeat = PyLong_AsLongLong(value);
+    if (repeat == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+
+    if (repeat < 0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return -1;
+    }
+
+    uv_timer_set_repeat((uv_timer_t *)UV_HANDLE(self), NS_TO_MS(repeat));
+
+    return 0;
+}
+
+
+static PyObject *
+Timer_slack_get(Timer *self, void *closure)
+{
+    UNUSED_ARG(closure);
+    return PyFloat_FromDouble(self->slack / 1000.0);
+}
+
+
+static int
+Timer_slack_set(Timer *self, PyObject *value, void *closure)
+{
+    double slack;
+
+    UNUSED_ARG(closure);
+
+    if (!value) {
+        PyErr_SetString(PyExc_TypeError, "cannot delete attribute");
+        return -1;
+    }
+
+    slack = PyFloat_AsDouble(value);
+    if (slack == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+
+    if (slack < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "a positive float or 0.0 is required");
+        return -1;
+    }
+
+    self->slack = (uint64_t)(slack * 1000);
+
+    return 0;
+}
+
+
 static int
 Timer_tp_init(Timer *self, PyObject *args, PyObject *kwargs)
 {
@@ -169,11 +310,7 @@ Timer_tp_init(Timer *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_timer = PyMem_Malloc(sizeof(uv_timer_t));
-    if (!uv_timer) {
-        PyErr_NoMemory();
-        return -1;
-    }
+    uv_timer = &self->timer_h;
 
     r = uv_timer_init(UV_HANDLE_LOOP(self), uv_timer);
     if (r != 0) {
@@ -220,7 +357,8 @@ Timer_tp_clear(Timer *self)
 
 static PyMethodDef
 Timer_tp_methods[] = {
-    { "start", (PyCFunction)Timer_func_start, METH_VARARGS|METH_KEYWORDS, "Start the Timer." },
+    { "start", (PyCFunction)Timer_func_start, PYUV_METH_FASTCALL_KEYWORDS, "Start the Timer." },
+    { "start_ns", (PyCFunction)Timer_func_start_ns, METH_VARARGS|METH_KEYWORDS, "Start the Timer, using timeout and repeat values expressed in nanoseconds." },
     { "stop", (PyCFunction)Timer_func_stop, METH_NOARGS, "Stop the Timer." },
     { "again", (PyCFunction)Timer_func_again, METH_NOARGS, "Stop the timer, and if it is repeating restart it using the repeat value as the timeout." },
     { NULL }
@@ -229,6 +367,8 @@ Timer_tp_methods[] = {
 
 static PyGetSetDef Timer_tp_getsets[] = {
     {"repeat", (getter)Timer_repeat_get, (setter)Timer_repeat_set, "Timer repeat value.", NULL},
+    {"repeat_ns", (getter)Timer_repeat_ns_get, (setter)Timer_repeat_ns_set, "Timer repeat value, in nanoseconds.", NULL},
+    {"slack", (getter)Timer_slack_get, (setter)Timer_slack_set, "Time the timer expiration can be delayed in order to coalesce it with other timers.", NULL},
     {NULL}
 };
 
@@ -275,3 +415,407 @@ static PyTypeObject TimerType = {
 };
 
 
+
+
+
+/* TimerWheel */
+
+static void
+on_timer_wheel_expired(timer_wheel_t *wheel, tw_entry_t *expired)
+{
+    PyGILState_STATE gstate = pyuv_gil_ensure(wheel->timer_handle.loop);
+    tw_entry_t *entry;
+    TimerWheel *self;
+    TimerWheelEntry *item;
+    PyObject *result;
+    uint64_t start;
+
+    self = (TimerWheel *)wheel->data;
+    ASSERT(self);
+    /* Object could go out of scope in the callback, increase refcount to avoid it */
+    Py_INCREF(self);
+
+    /* all expired entries are processed while holding the GIL once */
+    self->expired = expired;
+
+    while (!tw_list_empty(expired)) {
+        entry = expired->next;
+        tw_entry_unlink(entry);
+        item = container_of(entry, TimerWheelEntry, entry);
+
+        start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+        result = pyuv_call1(item->callback, (PyObject *)item);
+        pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_TIMER, start, (PyObject *)item, item->callback);
+        if (result == NULL) {
+            handle_uncaught_exception(((Handle *)self)->loop);
+        }
+        Py_XDECREF(result);
+
+        /* reference was taken when the entry was scheduled */
+        Py_DECREF(item);
+    }
+
+    self->expired = NULL;
+
+    Py_DECREF(self);
+    PyGILState_Release(gstate);
+}
+
+
+static INLINE void
+timer_wheel_handle_cancel_list(TimerWheel *self, tw_entry_t *head)
+{
+    tw_entry_t *entry;
+
+    while (!tw_list_empty(head)) {
+        entry = head->next;
+        timer_wheel_remove(self->wheel, entry);
+        Py_DECREF(container_of(entry, TimerWheelEntry, entry));
+    }
+}
+
+
+/* cancel all scheduled entries, including those about to be fired */
+static void
+timer_wheel_handle_cancel_all(TimerWheel *self)
+{
+    size_t i, n;
+
+    n = (size_t)TIMER_WHEEL_LEVELS << self->wheel->bits;
+    for (i = 0; i < n; i++) {
+        timer_wheel_handle_cancel_list(self, &self->wheel->slots[i]);
+    }
+    if (self->expired) {
+        timer_wheel_handle_cancel_list(self, self->expired);
+    }
+}
+
+
+static PyObject *
+TimerWheel_func_schedule(TimerWheel *self, PyObject *args)
+{
+    double timeout;
+    TimerWheelEntry *item;
+    PyObject *callback;
+
+    RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
+
+    if (!PyArg_ParseTuple(args, "Od:schedule", &callback, &timeout)) {
+        return NULL;
+    }
+
+    if (!PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "a callable is required");
+        return NULL;
+    }
+
+    if (!(timeout >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    if (timeout * 1000 >= (double)TIMER_WHEEL_MAX_TIMEOUT) {
+        PyErr_SetString(PyExc_OverflowError, "timeout is too large");
+        return NULL;
+    }
+
+    item = PyObject_GC_New(TimerWheelEntry, &TimerWheelEntryType);
+    if (!item) {
+        return NULL;
+    }
+    tw_entry_init(&item->entry);
+    Py_INCREF(self);
+    item->wheel = self;
+    Py_INCREF(callback);
+    item->callback = callback;
+    PyObject_GC_Track(item);
+
+    timer_wheel_add(self->wheel, &item->entry, (uint64_t)(timeout * 1000));
+
+    /* the wheel keeps a reference while the entry is scheduled */
+    Py_INCREF(item);
+    return (PyObject *)item;
+}
+
+
+static PyObject *
+TimerWheel_func_close(TimerWheel *self, PyObject *args)
+{
+    PyObject *result;
+
+    result = Handle_func_close((Handle *)self, args);
+    if (result) {
+        timer_wheel_handle_cancel_all(self);
+        /* the wheel itself is freed with the timer handle */
+        PyMem_Free(self->wheel->slots);
+        self->wheel = NULL;
+    }
+    return result;
+}
+
+
+static PyObject *
+TimerWheel_pending_get(TimerWheel *self, void *closure)
+{
+    UNUSED_ARG(closure);
+
+    if (!self->wheel) {
+        return PyInt_FromSsize_t(0);
+    }
+    return PyInt_FromSsize_t(self->wheel->count);
+}
+
+
+static int
+TimerWheel_tp_init(TimerWheel *self, PyObject *args, PyObject *kwargs)
+{
+    unsigned int slots, bits;
+    double tick;
+    Loop *loop;
+    timer_wheel_t *wheel;
+    PyObject *tmp = NULL;
+
+    static char *kwlist[] = {"loop", "tick", "slots", NULL};
+
+    slots = 256;
+
+    if (UV_HANDLE(self)) {
+        PyErr_SetString(PyExc_TimerError, "Object already initialized");
+        return -1;
+    }
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!d|I:__init__", kwlist, &LoopType, &loop, &tick, &slots)) {
+        return -1;
+    }
+
+    /* tick is given in seconds, like every other time in pyuv, and kept in milliseconds */
+    if (!(tick >= 0.001)) {
+        PyErr_SetString(PyExc_ValueError, "tick must be at least 1 millisecond");
+        return -1;
+    }
+
+    /* the wheel is driven by a libuv timer, which takes a signed 64 bit timeout */
+    if (tick * 1000 >= (double)INT64_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "tick is too large");
+        return -1;
+    }
+
+    for (bits = 1; bits * TIMER_WHEEL_LEVELS < 64 && ((unsigned int)1 << bits) < slots; bits++);
+    if (bits * TIMER_WHEEL_LEVELS >= 64 || ((unsigned int)1 << bits) != slots) {
+        PyErr_SetString(PyExc_ValueError, "slots must be a power of 2, between 2 and 32768");
+        return -1;
+    }
+
+    wheel = timer_wheel_new(loop->uv_loop, (uint64_t)(tick * 1000), bits, on_timer_wheel_expired);
+    if (!wheel) {
+        return -1;
+    }
+    wheel->data = (void *)self;
+    wheel->timer_handle.data = (void *)self;
+
+    tmp = (PyObject *)((Handle *)self)->loop;
+    Py_INCREF(loop);
+    ((Handle *)self)->loop = loop;
+    Py_XDECREF(tmp);
+
+    self->wheel = wheel;
+    /* the timer is the first member of the wheel, both are freed together when it's closed */
+    UV_HANDLE(self) = (uv_handle_t *)&wheel->timer_handle;
+    ((Handle *)self)->uv_handle_external = True;
+
+    return 0;
+}
+
+
+static PyObject *
+TimerWheel_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    TimerWheel *self = (TimerWheel *)HandleType.tp_new(type, args, kwargs);
+    if (!self) {
+        return NULL;
+    }
+    self->wheel = NULL;
+    self->expired = NULL;
+    return (PyObject *)self;
+}
+
+
+static void
+TimerWheel_tp_dealloc(TimerWheel *self)
+{
+    /* scheduled entries keep the wheel alive, so there are none left at this point */
+    if (self->wheel) {
+        PyMem_Free(self->wheel->slots);
+        self->wheel = NULL;
+    }
+    HandleType.tp_dealloc((PyObject *)self);
+}
+
+
+static PyMethodDef
+TimerWheel_tp_methods[] = {
+    { "schedule", (PyCFunction)TimerWheel_func_schedule, METH_VARARGS, "Schedule a callback to be called after the given timeout." },
+    { "close", (PyCFunction)TimerWheel_func_close, METH_VARARGS, "Close the wheel and cancel all scheduled entries." },
+    { NULL }
+};
+
+
+static PyGetSetDef TimerWheel_tp_getsets[] = {
+    {"pending", (getter)TimerWheel_pending_get, NULL, "Number of scheduled entries.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject TimerWheelType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.TimerWheel",                                              /*tp_name*/
+    sizeof(TimerWheel),                                             /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)TimerWheel_tp_dealloc,                              /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    0,                                                              /*tp_traverse*/
+    0,                                                              /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    TimerWheel_tp_methods,                                          /*tp_methods*/
+    0,                                                              /*tp_members*/
+    TimerWheel_tp_getsets,                                          /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    (initproc)TimerWheel_tp_init,                                   /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    TimerWheel_tp_new,                                              /*tp_new*/
+};
+
+
+/* TimerWheelEntry */
+
+static PyObject *
+TimerWheelEntry_func_cancel(TimerWheelEntry *self)
+{
+    if (tw_entry_active(&self->entry)) {
+        timer_wheel_remove(self->wheel->wheel, &self->entry);
+        /* reference was taken when the entry was scheduled */
+        Py_DECREF(self);
+    }
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+TimerWheelEntry_active_get(TimerWheelEntry *self, void *closure)
+{
+    UNUSED_ARG(closure);
+
+    return PyBool_FromLong((long)tw_entry_active(&self->entry));
+}
+
+
+static int
+TimerWheelEntry_tp_traverse(TimerWheelEntry *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->wheel);
+    Py_VISIT(self->callback);
+    return 0;
+}
+
+
+static int
+TimerWheelEntry_tp_clear(TimerWheelEntry *self)
+{
+    Py_CLEAR(self->wheel);
+    Py_CLEAR(self->callback);
+    return 0;
+}
+
+
+static void
+TimerWheelEntry_tp_dealloc(TimerWheelEntry *self)
+{
+    PyObject_GC_UnTrack(self);
+    TimerWheelEntry_tp_clear(self);
+    PyObject_GC_Del(self);
+}
+
+
+static PyMethodDef
+TimerWheelEntry_tp_methods[] = {
+    { "cancel", (PyCFunction)TimerWheelEntry_func_cancel, METH_NOARGS, "Cancel the entry, if it's still scheduled." },
+    { NULL }
+};
+
+
+static PyMemberDef TimerWheelEntry_tp_members[] = {
+    {"wheel", T_OBJECT_EX, offsetof(TimerWheelEntry, wheel), READONLY, "TimerWheel this entry was scheduled on."},
+    {"callback", T_OBJECT_EX, offsetof(TimerWheelEntry, callback), READONLY, "Callback to be called when the entry expires."},
+    {NULL}
+};
+
+
+static PyGetSetDef TimerWheelEntry_tp_getsets[] = {
+    {"active", (getter)TimerWheelEntry_active_get, NULL, "Indicates if this entry is still scheduled.", NULL},
+    {NULL}
+};
+
+
+static PyTypeObject TimerWheelEntryType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyuv.TimerWheelEntry",                                         /*tp_name*/
+    sizeof(TimerWheelEntry),                                        /*tp_basicsize*/
+    0,                                                              /*tp_itemsize*/
+    (destructor)TimerWheelEntry_tp_dealloc,                         /*tp_dealloc*/
+    0,                                                              /*tp_print*/
+    0,                                                              /*tp_getattr*/
+    0,                                                              /*tp_setattr*/
+    0,                                                              /*tp_compare*/
+    0,                                                              /*tp_repr*/
+    0,                                                              /*tp_as_number*/
+    0,                                                              /*tp_as_sequence*/
+    0,                                                              /*tp_as_mapping*/
+    0,                                                              /*tp_hash */
+    0,                                                              /*tp_call*/
+    0,                                                              /*tp_str*/
+    0,                                                              /*tp_getattro*/
+    0,                                                              /*tp_setattro*/
+    0,                                                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,                        /*tp_flags*/
+    0,                                                              /*tp_doc*/
+    (traverseproc)TimerWheelEntry_tp_traverse,                      /*tp_traverse*/
+    (inquiry)TimerWheelEntry_tp_clear,                              /*tp_clear*/
+    0,                                                              /*tp_richcompare*/
+    0,                                                              /*tp_weaklistoffset*/
+    0,                                                              /*tp_iter*/
+    0,                                                              /*tp_iternext*/
+    TimerWheelEntry_tp_methods,                                     /*tp_methods*/
+    TimerWheelEntry_tp_members,                                     /*tp_members*/
+    TimerWheelEntry_tp_getsets,                                     /*tp_getsets*/
+    0,                                                              /*tp_base*/
+    0,                                                              /*tp_dict*/
+    0,                                                              /*tp_descr_get*/
+    0,                                                              /*tp_descr_set*/
+    0,                                                              /*tp_dictoffset*/
+    0,                                                              /*tp_init*/
+    0,                                                              /*tp_alloc*/
+    0,                                                              /*tp_new*/
+};
+
@@ -0,0 +1,332 @@
+
+/*
+ * Hierarchical timer wheel. Entries are intrusive (embedded in the structure they
+ * belong to) and kept in per-slot circular lists. Level 0 has one slot per tick,
+ * each slot in level N covers a full turn of level N-1, entries in upper levels are
+ * cascaded down when the lower level wraps around. A single uv_timer_t drives the
+ * wheel and it's only scheduled for ticks which have work to do.
+ */
+
+#define TW_SLOT(wheel, level, index) (&(wheel)->slots[((level) << (wheel)->bits) + (index)])
+
+/* longest timeout accepted by timer_wheel_add, in milliseconds: it's added to the loop time
+ * without overflowing, and the driving libuv timer takes a signed 64 bit timeout */
+#define TIMER_WHEEL_MAX_TIMEOUT ((uint64_t)INT64_MAX)
+
+
+static INLINE void
+tw_list_init(tw_entry_t *head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+
+static INLINE int
+tw_list_empty(tw_entry_t *head)
+{
+    return head->next == head;
+}
+
+
+static INLINE void
+tw_list_append(tw_entry_t *head, tw_entry_t *entry)
+{
+    entry->prev = head->prev;
+    entry->next = head;
+    head->prev->next = entry;
+    head->prev = entry;
+}
+
+
+static INLINE void
+tw_entry_unlink(tw_entry_t *entry)
+{
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+    entry->next = NULL;
+    entry->prev = NULL;
+}
+
+
+static INLINE void
+tw_entry_init(tw_entry_t *entry)
+{
+    entry->next = NULL;
+    entry->prev = NULL;
+    entry->expires = 0;
+}
+
+
+static INLINE int
+tw_entry_active(tw_entry_t *entry)
+{
+    return entry->next != NULL;
+}
+
+
+static void
+timer_wheel_insert(timer_wheel_t *wheel, tw_entry_t *entry)
+{
+    int level;
+    uint64_t delta, expires;
+
+    if (entry->expires <= wheel->current) {
+        entry->expires = wheel->current + 1;
+    }
+    expires = entry->expires;
+    delta = expires - wheel->current;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+        if (delta < ((uint64_t)1 << (wheel->bits * (level + 1)))) {
+            break;
+        }
+    }
+
+    if (level == TIMER_WHEEL_LEVELS - 1 && delta >= ((uint64_t)1 << (wheel->bits * TIMER_WHEEL_LEVELS))) {
+        /* too far in the future, park it in the farthest slot, it will be cascaded again */
+        expires = wheel->current + ((uint64_t)1 << (wheel->bits * TIMER_WHEEL_LEVELS)) - 1;
+    }
+
+    tw_list_append(TW_SLOT(wheel, level, (expires >> (wheel->bits * level)) & wheel->mask), entry);
+}
+
+
+/* current loop time expressed in wheel ticks */
+static INLINE uint64_t
+timer_wheel_now(timer_wheel_t *wheel)
+{
+    return ((uint64_t)uv_now(wheel->timer_handle.loop) - wheel->base) / wheel->tick;
+}
+
+
+static void on_timer_wheel_timer(uv_timer_t *handle, int status);
+
+
+/* arm the timer for the next tick which needs processing: a non empty level 0 slot or a cascade */
+static void
+timer_wheel_schedule(timer_wheel_t *wheel)
+{
+    uint64_t t, boundary, due, now;
+
+    if (wheel->count == 0) {
+        uv_timer_stop(&wheel->timer_handle);
+        wheel->scheduled = 0;
+        return;
+    }
+
+    boundary = (wheel->current | wheel->mask) + 1;
+    for (t = wheel->current + 1; t < boundary; t++) {
+        if (!tw_list_empty(TW_SLOT(wheel, 0, t & wheel->mask))) {
+            break;
+        }
+    }
+
+    if (wheel->scheduled == t && uv_is_active((uv_handle_t *)&wheel->timer_handle)) {
+        return;
+    }
+
+    due = wheel->base + t * wheel->tick;
+    now = (uint64_t)uv_now(wheel->timer_handle.loop);
+    wheel->scheduled = t;
+    uv_timer_start(&wheel->timer_handle, on_timer_wheel_timer, (due > now) ? due - now : 0, 0);
+}
+
+
+/* advance the wheel up to the given tick, moving expired entries to the expired list */
+static void
+timer_wheel_advance(timer_wheel_t *wheel, uint64_t target, tw_entry_t *expired)
+{
+    int level;
+    uint64_t index;
+    tw_entry_t *slot, *entry;
+
+    while (wheel->current < target) {
+        wheel->current++;
+
+        /* cascade upper levels when the lower one wraps around */
+        for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if ((wheel->current & (((uint64_t)1 << (wheel->bits * level)) - 1)) != 0) {
+                break;
+            }
+            index = (wheel->current >> (wheel->bits * level)) & wheel->mask;
+            slot = TW_SLOT(wheel, level, index);
+            while (!tw_list_empty(slot)) {
+                entry = slot->next;
+                tw_entry_unlink(entry);
+                timer_wheel_insert(wheel, entry);
+            }
+        }
+
+        slot = TW_SLOT(wheel, 0, wheel->current & wheel->mask);
+        while (!tw_list_empty(slot)) {
+            entry = slot->next;
+            tw_entry_unlink(entry);
+            tw_list_append(expired, entry);
+            wheel->count--;
+        }
+    }
+}
+
+
+static void
+on_timer_wheel_timer(uv_timer_t *handle, int status)
+{
+    timer_wheel_t *wheel;
+    tw_entry_t expired;
+
+    ASSERT(handle);
+    UNUSED_ARG(status);
+
+    wheel = (timer_wheel_t *)handle;
+    wheel->scheduled = 0;
+
+    tw_list_init(&expired);
+    timer_wheel_advance(wheel, timer_wheel_now(wheel), &expired);
+    if (!tw_list_empty(&expired)) {
+        wheel->expire_cb(wheel, &expired);
+        /* the callback must consume all entries, make sure none points to our stack */
+        while (!tw_list_empty(&expired)) {
+            tw_entry_unlink(expired.next);
+        }
+        /* the wheel could have been closed in the callback */
+        if (uv_is_closing((uv_handle_t *)handle)) {
+            return;
+        }
+    }
+
+    timer_wheel_schedule(wheel);
+}
+
+
+/* add (or move) an entry so that it expires after the given amount of milliseconds */
+static void
+timer_wheel_add(timer_wheel_t *wheel, tw_entry_t *entry, uint64_t timeout)
+{
+    uint64_t now;
+
+    if (wheel->count == 0) {
+        /* nothing is queued, skip the ticks which elapsed while the wheel was empty */
+        now = timer_wheel_now(wheel);
+        if (now > wheel->current) {
+            wheel->current = now;
+        }
+    }
+
+    if (tw_entry_active(entry)) {
+        tw_entry_unlink(entry);
+        /* entries in the expired list were already discounted */
+        if (entry->expires <= wheel->current) {
+            wheel->count++;
+        }
+    } else {
+        wheel->count++;
+    }
+
+    now = (uint64_t)uv_now(wheel->timer_handle.loop) - wheel->base;
+    /* round up, an entry never expires early */
+    entry->expires = (now + timeout + wheel->tick - 1) / wheel->tick;
+    timer_wheel_insert(wheel, entry);
+
+    if (wheel->scheduled == 0 || entry->expires < wheel->scheduled) {
+        timer_wheel_schedule(wheel);
+    }
+}
+
+
+/* remove an entry from the wheel, it's safe to call it for inactive entries */
+static void
+timer_wheel_remove(timer_wheel_t *wheel, tw_entry_t *entry)
+{
+    if (!tw_entry_active(entry)) {
+        return;
+    }
+    tw_entry_unlink(entry);
+    /* entries in the expired list were already discounted */
+    if (entry->expires > wheel->current) {
+        wheel->count--;
+        /* don't keep the loop alive for nothing */
+        if (wheel->count == 0) {
+            uv_timer_stop(&wheel->timer_handle);
+            wheel->scheduled = 0;
+        }
+    }
+}
+
+
+static timer_wheel_t *
+timer_wheel_new(uv_loop_t *loop, uint64_t tick, unsigned int bits, timer_wheel_cb expire_cb)
+{
+    int r;
+    size_t i, n;
+    timer_wheel_t *wheel;
+
+    ASSERT(tick > 0);
+    ASSERT(bits > 0 && bits * TIMER_WHEEL_LEVELS < 64);
+
+    wheel = (timer_wheel_t *)PyMem_Malloc(sizeof(timer_wheel_t));
+    if (!wheel) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    n = (size_t)TIMER_WHEEL_LEVELS << bits;
+    wheel->slots = (tw_entry_t *)PyMem_Malloc(sizeof(tw_entry_t) * n);
+    if (!wheel->slots) {
+        PyMem_Free(wheel);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        tw_list_init(&wheel->slots[i]);
+    }
+
+    r = uv_timer_init(loop, &wheel->timer_handle);
+    if (r != 0) {
+        RAISE_UV_EXCEPTION(loop, PyExc_TimerError);
+        PyMem_Free(wheel->slots);
+        PyMem_Free(wheel);
+        return NULL;
+    }
+    /* internal handle, not visible to Loop.walk */
+    wheel->timer_handle.data = NULL;
+
+    wheel->bits = bits;
+    wheel->mask = ((uint64_t)1 << bits) - 1;
+    wheel->base = (uint64_t)uv_now(loop);
+    wheel->tick = tick;
+    wheel->current = 0;
+    wheel->scheduled = 0;
+    wheel->count = 0;
+    wheel->expire_cb = expire_cb;
+    wheel->data = NULL;
+
+    return wheel;
+}
+
+
+static void
+on_timer_wheel_close(uv_handle_t *handle)
+{
+    timer_wheel_t *wheel = (timer_wheel_t *)handle;
+    PyMem_Free(wheel->slots);
+    PyMem_Free(wheel);
+}
+
+
+/* close the timer and free the wheel, remaining entries are just forgotten */
+static void
+timer_wheel_close(timer_wheel_t *wheel)
+{
+    uv_close((uv_handle_t *)&wheel->timer_handle, on_timer_wheel_close);
+}
+
+
+/* free the wheel memory after the loop it was running on has been deleted */
+static void
+timer_wheel_destroy(timer_wheel_t *wheel)
+{
+    PyMem_Free(wheel->slots);
+    PyMem_Free(wheel);
+}
+
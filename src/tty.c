@@ -90,12 +90,7 @@ TTY_tp_init(TTY *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_tty = PyMem_Malloc(sizeof(uv_tty_t));
-    if (!uv_tty) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_tty = &self->tty_h;
 
     r = uv_tty_init(UV_HANDLE_LOOP(self), uv_tty, fd, (readable == Py_True) ? 1 : 0);
     if (r != 0) {
@@ -12,23 +12,22 @@ typedef struct {
 static uv_buf_t
 on_udp_alloc(uv_udp_t* handle, size_t suggested_size)
 {
-    static char slab[65536];
-    ASSERT(suggested_size <= sizeof(slab));
-    UNUSED_ARG(handle);
-    return uv_buf_init(slab, sizeof(slab));
+    ASSERT(suggested_size <= PYUV_READ_SLAB_SIZE);
+    return loop_read_buffer(handle->loop);
 }
 
 
 static void
 on_udp_read(uv_udp_t* handle, int nread, uv_buf_t buf, struct sockaddr* addr, unsigned flags)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(handle->loop);
     char ip[INET6_ADDRSTRLEN];
     struct sockaddr_in addr4;
     struct sockaddr_in6 addr6;
     uv_err_t err;
     UDP *self;
     PyObject *result, *address_tuple, *data, *py_errorno;
+    uint64_t start;
 
     ASSERT(handle);
     ASSERT(flags == 0);
@@ -66,7 +65,9 @@ on_udp_read(uv_udp_t* handle, int nread, uv_buf_t buf, struct sockaddr* addr, un
         py_errorno = PyInt_FromLong((long)err.code);
     }
 
-    result = PyObject_CallFunctionObjArgs(self->on_read_cb, self, address_tuple, data, py_errorno, NULL);
+    start = pyuv_metrics_start(UV_HANDLE_LOOP(self));
+    result = pyuv_call4(self->on_read_cb, (PyObject *)self, address_tuple, data, py_errorno);
+    pyuv_metrics_end(UV_HANDLE_LOOP(self), PYUV_METRIC_UDP_RECV, start, (PyObject *)self, self->on_read_cb);
     if (result == NULL) {
         handle_uncaught_exception(((Handle *)self)->loop);
     }
@@ -84,7 +85,7 @@ done:
 static void
 on_udp_send(uv_udp_send_t* req, int status)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->handle->loop);
     int i;
     udp_send_data_t* req_data;
     UDP *self;
@@ -109,7 +110,7 @@ on_udp_send(uv_udp_send_t* req, int status)
             py_errorno = Py_None;
             Py_INCREF(Py_None);
         }
-        result = PyObject_CallFunctionObjArgs(callback, self, py_errorno, NULL);
+        result = pyuv_call2(callback, (PyObject *)self, py_errorno);
         if (result == NULL) {
             handle_uncaught_exception(((Handle *)self)->loop);
         }
@@ -226,13 +227,13 @@ UDP_func_stop_recv(UDP *self)
 
 
 static PyObject *
-UDP_func_send(UDP *self, PyObject *args)
+UDP_func_send(UDP *self, PYUV_FASTCALL_PARAMS)
 {
     int r, dest_port, address_type;
     char *dest_ip;
     uv_buf_t buf;
     Py_buffer pbuf;
-    PyObject *callback;
+    PyObject *address, *data, *callback;
     uv_udp_send_t *wr = NULL;
     udp_send_data_t *req_data = NULL;
 
@@ -240,12 +241,15 @@ UDP_func_send(UDP *self, PyObject *args)
 
     RAISE_IF_HANDLE_CLOSED(self, PyExc_HandleClosedError, NULL);
 
-    if (!PyArg_ParseTuple(args, "(si)s*|O:send", &dest_ip, &dest_port, &pbuf, &callback)) {
+    if (!PYUV_UNPACK_ARGS("send", 2, 3, &address, &data, &callback)) {
+        return NULL;
+    }
+
+    if (!PyArg_Parse(address, "(si):send", &dest_ip, &dest_port)) {
         return NULL;
     }
 
     if (callback != Py_None && !PyCallable_Check(callback)) {
-        PyBuffer_Release(&pbuf);
         PyErr_SetString(PyExc_TypeError, "a callable or None is required");
         return NULL;
     }
@@ -260,6 +264,10 @@ UDP_func_send(UDP *self, PyObject *args)
         return NULL;
     }
 
+    if (!PyArg_Parse(data, "s*:send", &pbuf)) {
+        return NULL;
+    }
+
     Py_INCREF(callback);
 
     wr = (uv_udp_send_t *)PyMem_Malloc(sizeof(uv_udp_send_t));
@@ -594,12 +602,7 @@ UDP_tp_init(UDP *self, PyObject *args, PyObject *kwargs)
     ((Handle *)self)->loop = loop;
     Py_XDECREF(tmp);
 
-    uv_udp_handle = PyMem_Malloc(sizeof(uv_udp_t));
-    if (!uv_udp_handle) {
-        PyErr_NoMemory();
-        Py_DECREF(loop);
-        return -1;
-    }
+    uv_udp_handle = &self->udp_h;
     r = uv_udp_init(UV_HANDLE_LOOP(self), uv_udp_handle);
     if (r != 0) {
         RAISE_UV_EXCEPTION(UV_HANDLE_LOOP(self), PyExc_UDPError);
@@ -647,7 +650,7 @@ UDP_tp_methods[] = {
     { "bind", (PyCFunction)UDP_func_bind, METH_VARARGS, "Bind to the specified IP and port." },
     { "start_recv", (PyCFunction)UDP_func_start_recv, METH_VARARGS, "Start accepting data." },
     { "stop_recv", (PyCFunction)UDP_func_stop_recv, METH_NOARGS, "Stop receiving data." },
-    { "send", (PyCFunction)UDP_func_send, METH_VARARGS, "Send data over UDP." },
+    { "send", (PyCFunction)UDP_func_send, PYUV_METH_FASTCALL, "Send data over UDP." },
     { "sendlines", (PyCFunction)UDP_func_sendlines, METH_VARARGS, "Send a sequence of data over UDP." },
     { "getsockname", (PyCFunction)UDP_func_getsockname, METH_NOARGS, "Get local socket information." },
     { "open", (PyCFunction)UDP_func_open, METH_VARARGS, "Open the specified file descriptor and manage it as a UDP handle." },
@@ -208,6 +208,38 @@ setup_args(void)
 }
 
 
+static PyObject *
+Util_func_set_freelist_size(PyObject *obj, PyObject *args)
+{
+    Py_ssize_t size;
+
+    UNUSED_ARG(obj);
+
+    if (!PyArg_ParseTuple(args, "n:set_freelist_size", &size)) {
+        return NULL;
+    }
+
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError, "a positive value or zero is required");
+        return NULL;
+    }
+
+    if (handle_freelist_resize(size) != 0) {
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+static PyObject *
+Util_func_get_freelist_size(PyObject *obj)
+{
+    UNUSED_ARG(obj);
+    return PyInt_FromSsize_t(handle_freelist_size);
+}
+
+
 static PyObject *
 Util_func_set_process_title(PyObject *obj, PyObject *args)
 {
@@ -301,7 +333,7 @@ makesockaddr(struct sockaddr *addr, int addrlen)
 static void
 getaddrinfo_cb(uv_getaddrinfo_t* req, int status, struct addrinfo* res)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_STATE gstate = pyuv_gil_ensure(req->loop);
     struct addrinfo *ptr;
     uv_err_t err;
     Loop *loop;
@@ -352,7 +384,7 @@ getaddrinfo_cb(uv_getaddrinfo_t* req, int status, struct addrinfo* res)
     Py_INCREF(Py_None);
 
 callback:
-    result = PyObject_CallFunctionObjArgs(callback, dns_result, errorno, NULL);
+    result = pyuv_call2(callback, dns_result, errorno);
     if (result == NULL) {
         handle_uncaught_exception(loop);
     }
@@ -460,6 +492,8 @@ Util_methods[] = {
     { "set_process_title", (PyCFunction)Util_func_set_process_title, METH_VARARGS, "Sets current process title." },
     { "get_process_title", (PyCFunction)Util_func_get_process_title, METH_NOARGS, "Gets current process title." },
     { "getaddrinfo", (PyCFunction)Util_func_getaddrinfo, METH_VARARGS|METH_KEYWORDS, "Getaddrinfo" },
+    { "set_freelist_size", (PyCFunction)Util_func_set_freelist_size, METH_VARARGS, "Set the maximum number of deallocated handle objects kept for reuse, per type." },
+    { "get_freelist_size", (PyCFunction)Util_func_get_freelist_size, METH_NOARGS, "Get the maximum number of deallocated handle objects kept for reuse, per type." },
     { NULL }
 };
 
@@ -0,0 +1,107 @@
+
+from __future__ import print_function
+
+import sys
+sys.path.insert(0, '../')
+import time
+import pyuv
+
+
+# Measure the per call cost of hot methods (inbound calls into pyuv) and of callback
+# dispatch (outbound calls from pyuv). On Python >= 3.7 the methods use METH_FASTCALL
+# and on Python >= 3.9 callbacks are dispatched with vectorcall, run this script with
+# different interpreters (or pyuv versions) to compare.
+
+COUNT = 500000
+
+
+def bench_timer_start():
+    loop = pyuv.Loop()
+    timer = pyuv.Timer(loop)
+    cb = lambda handle: None
+    t0 = time.time()
+    for x in range(COUNT):
+        timer.start(cb, 10.0, 0.0)
+    elapsed = time.time() - t0
+    timer.close()
+    loop.run()
+    return elapsed
+
+
+def bench_timer_start_kwargs():
+    loop = pyuv.Loop()
+    timer = pyuv.Timer(loop)
+    cb = lambda handle: None
+    t0 = time.time()
+    for x in range(COUNT):
+        timer.start(cb, timeout=10.0, repeat=0.0)
+    elapsed = time.time() - t0
+    timer.close()
+    loop.run()
+    return elapsed
+
+
+def bench_udp_send():
+    loop = pyuv.Loop()
+    server = pyuv.UDP(loop)
+    server.bind(("127.0.0.1", 0))
+    address = server.getsockname()
+    client = pyuv.UDP(loop)
+    data = b'x' * 16
+    count = COUNT // 10
+    t0 = time.time()
+    for x in range(count):
+        client.send(address, data)
+    loop.run()
+    elapsed = time.time() - t0
+    client.close()
+    server.close()
+    loop.run()
+    return elapsed * COUNT / count
+
+
+def bench_callbacks():
+    loop = pyuv.Loop()
+    state = {'count': 0}
+    def idle_cb(handle):
+        state['count'] += 1
+        if state['count'] >= COUNT:
+            handle.close()
+    idle = pyuv.Idle(loop)
+    idle.start(idle_cb)
+    t0 = time.time()
+    loop.run(hold_gil=True)
+    return time.time() - t0
+
+
+class Protocol(object):
+
+    def __init__(self):
+        self.count = 0
+
+    def idle_cb(self, handle):
+        self.count += 1
+        if self.count >= COUNT:
+            handle.close()
+
+
+def bench_method_callbacks():
+    loop = pyuv.Loop()
+    protocol = Protocol()
+    idle = pyuv.Idle(loop)
+    idle.start(protocol.idle_cb)
+    t0 = time.time()
+    loop.run(hold_gil=True)
+    return time.time() - t0
+
+
+print("PyUV version %s, Python %s" % (pyuv.__version__, sys.version.split()[0]))
+
+for name, func in (('Timer.start', bench_timer_start),
+                   ('Timer.start (keywords)', bench_timer_start_kwargs),
+                   ('UDP.send', bench_udp_send),
+                   ('callback (function)', bench_callbacks),
+                   ('callback (bound method)', bench_method_callbacks)):
+    elapsed = func()
+    print("%-24s %7d calls: %.3fs (%.3f us/call)" % (name, COUNT, elapsed, elapsed * 1e6 / COUNT))
+
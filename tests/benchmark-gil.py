@@ -0,0 +1,89 @@
+
+from __future__ import print_function
+
+import os
+import sys
+sys.path.insert(0, '../')
+import time
+import pyuv
+
+
+# Dispatch a large number of events and compare running the loop with and without
+# holding the GIL. Idle and timer callbacks run outside of the poll phase, Async
+# and Pipe read callbacks run inside it, where the GIL is taken back once per iteration.
+
+COUNT = 200000
+PIPENAME = '/tmp/pyuv-benchmark-gil'
+
+
+def bench_idle(hold_gil):
+    loop = pyuv.Loop()
+    handles = [pyuv.Idle(loop) for x in range(10)]
+    state = {'count': 0}
+    def idle_cb(handle):
+        state['count'] += 1
+        if state['count'] >= COUNT:
+            [h.close() for h in handles]
+    [h.start(idle_cb) for h in handles]
+    t0 = time.time()
+    loop.run(hold_gil=hold_gil)
+    return time.time() - t0
+
+
+def bench_async(hold_gil):
+    loop = pyuv.Loop()
+    state = {'count': 0}
+    def async_cb(handle):
+        state['count'] += 1
+        if state['count'] >= COUNT:
+            handle.close()
+        else:
+            handle.send()
+    async_h = pyuv.Async(loop, async_cb)
+    async_h.send()
+    t0 = time.time()
+    loop.run(hold_gil=hold_gil)
+    return time.time() - t0
+
+
+def bench_pipe(hold_gil):
+    loop = pyuv.Loop()
+    server = pyuv.Pipe(loop)
+    client = pyuv.Pipe(loop)
+    state = {'count': 0, 'conn': None}
+    data = b'x' * 16
+    def on_read(handle, buf, error):
+        if buf is None:
+            handle.close()
+            return
+        state['count'] += len(buf) // len(data)
+        if state['count'] >= COUNT // 10:
+            handle.close()
+            client.close()
+            server.close()
+        else:
+            client.write(data)
+    def on_connection(server, error):
+        conn = pyuv.Pipe(loop)
+        server.accept(conn)
+        conn.start_read(on_read)
+        state['conn'] = conn
+    def on_connect(handle, error):
+        client.write(data)
+    if os.path.exists(PIPENAME):
+        os.remove(PIPENAME)
+    server.bind(PIPENAME)
+    server.listen(on_connection)
+    client.connect(PIPENAME, on_connect)
+    t0 = time.time()
+    loop.run(hold_gil=hold_gil)
+    return time.time() - t0
+
+
+print("PyUV version %s" % pyuv.__version__)
+
+for name, func, count in (('idle', bench_idle, COUNT), ('async', bench_async, COUNT), ('pipe', bench_pipe, COUNT // 10)):
+    released = func(False)
+    held = func(True)
+    print("%-6s %7d events: released %.3fs (%.2f us/event), held %.3fs (%.2f us/event), %.1f%% faster" %
+          (name, count, released, released * 1e6 / count, held, held * 1e6 / count, (released - held) * 100.0 / released))
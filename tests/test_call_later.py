@@ -0,0 +1,136 @@
+
+import gc
+import weakref
+
+from common import unittest2
+import pyuv
+
+
+class CallLaterTest(unittest2.TestCase):
+
+    def test_call_later1(self):
+        self.calls = []
+        def cb(*args):
+            self.calls.append(args)
+        loop = pyuv.Loop.default_loop()
+        loop.call_later(0.2, cb, 3)
+        loop.call_later(0.1, cb, 1, 2)
+        loop.call_later(0.1, cb, 2)
+        loop.call_later(0, cb)
+        loop.run()
+        self.assertEqual(self.calls, [(), (1, 2), (2,), (3,)])
+
+    def test_call_later_cancel(self):
+        self.calls = []
+        def cb(*args):
+            self.calls.append(args)
+            call2.cancel()
+        loop = pyuv.Loop.default_loop()
+        call1 = loop.call_later(0.1, cb, 1)
+        call2 = loop.call_later(0.1, cb, 2)
+        call3 = loop.call_later(0.2, cb, 3)
+        call3.cancel()
+        self.assertTrue(call3.cancelled)
+        self.assertFalse(call1.cancelled)
+        loop.run()
+        self.assertEqual(self.calls, [(1,)])
+        self.assertTrue(call2.cancelled)
+
+    def test_call_at(self):
+        self.calls = []
+        def cb(*args):
+            self.calls.append(args)
+        loop = pyuv.Loop.default_loop()
+        call = loop.call_at(loop.now() / 1000.0 + 0.1, cb, 1)
+        self.assertTrue(call.when > loop.now() / 1000.0)
+        loop.call_at(0, cb, 0)
+        loop.run()
+        self.assertEqual(self.calls, [(0,), (1,)])
+
+    def test_call_later_slack(self):
+        self.times = []
+        def cb():
+            self.times.append(loop.now())
+        loop = pyuv.Loop.default_loop()
+        loop.slack = 0.1
+        loop.call_later(0.01, cb)
+        loop.call_later(0.05, cb)
+        loop.run()
+        loop.slack = 0
+        self.assertEqual(len(self.times), 2)
+        self.assertEqual(self.times[0], self.times[1])
+
+    def test_call_later_invalid(self):
+        loop = pyuv.Loop.default_loop()
+        self.assertRaises(TypeError, loop.call_later, 0.1)
+        self.assertRaises(TypeError, loop.call_later, 0.1, None)
+        self.assertRaises(ValueError, loop.call_later, -1, lambda: None)
+        self.assertRaises(OverflowError, loop.call_later, 1e300, lambda: None)
+        self.assertRaises(OverflowError, loop.call_at, 1e300, lambda: None)
+
+    def test_call_later_collect(self):
+        loop = pyuv.Loop()
+        loop.call_later(10, lambda: None)
+        loop.call_at(loop.now() / 1000.0 + 10, lambda: None)
+        ref = weakref.ref(loop)
+        del loop
+        gc.collect()
+        self.assertEqual(ref(), None)
+
+
+class CallSoonTest(unittest2.TestCase):
+
+    def test_call_soon(self):
+        self.calls = []
+        def cb(*args):
+            self.calls.append(args)
+            if args == (1,):
+                # scheduled from a callback, runs in the next iteration
+                loop.call_soon(cb, 3)
+        loop = pyuv.Loop.default_loop()
+        loop.call_soon(cb, 1)
+        loop.call_soon(cb, 2, 'a')
+        loop.call_soon(cb)
+        loop.run()
+        self.assertEqual(self.calls, [(1,), (2, 'a'), (), (3,)])
+
+    def test_call_soon_many(self):
+        self.count = 0
+        def cb():
+            self.count += 1
+        loop = pyuv.Loop.default_loop()
+        for i in range(1000):
+            loop.call_soon(cb)
+        loop.run()
+        self.assertEqual(self.count, 1000)
+
+    def test_call_soon_limit(self):
+        self.iterations = []
+        def cb(i):
+            self.iterations.append(self.check_count)
+        def check_cb(handle):
+            self.check_count += 1
+            if self.check_count == 5:
+                handle.close()
+        self.check_count = 0
+        loop = pyuv.Loop.default_loop()
+        check = pyuv.Check(loop)
+        check.start(check_cb)
+        loop.call_soon_limit = 2
+        for i in range(5):
+            loop.call_soon(cb, i)
+        loop.run()
+        loop.call_soon_limit = 0
+        self.assertEqual(self.iterations, [0, 0, 1, 1, 2])
+
+    def test_call_soon_invalid(self):
+        loop = pyuv.Loop.default_loop()
+        self.assertRaises(TypeError, loop.call_soon)
+        self.assertRaises(TypeError, loop.call_soon, None)
+        def set_limit():
+            loop.call_soon_limit = -1
+        self.assertRaises(ValueError, set_limit)
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
@@ -0,0 +1,70 @@
+
+import threading
+
+from common import unittest2
+import pyuv
+
+
+class ChannelTest(unittest2.TestCase):
+
+    def test_channel_send(self):
+        self.received = []
+        def channel_cb(channel, objs):
+            self.received.extend(objs)
+            if len(self.received) == 3:
+                channel.close()
+        loop = pyuv.Loop.default_loop()
+        channel = pyuv.Channel(loop, channel_cb)
+        channel.send(1)
+        channel.send('two')
+        channel.send(None)
+        self.assertEqual(channel.pending, 3)
+        loop.run()
+        self.assertEqual(self.received, [1, 'two', None])
+
+    def test_channel_batch(self):
+        self.batches = []
+        def channel_cb(channel, objs):
+            self.batches.append(objs)
+            channel.close()
+        loop = pyuv.Loop.default_loop()
+        channel = pyuv.Channel(loop, channel_cb)
+        for i in range(100):
+            channel.send(i)
+        loop.run()
+        self.assertEqual(self.batches, [list(range(100))])
+
+    def test_channel_threads(self):
+        self.received = []
+        count = 1000
+        nthreads = 4
+        def channel_cb(channel, objs):
+            self.received.extend(objs)
+            if len(self.received) == count * nthreads:
+                channel.close()
+        def thread_cb(n):
+            for i in range(count):
+                channel.send((n, i))
+        loop = pyuv.Loop.default_loop()
+        channel = pyuv.Channel(loop, channel_cb)
+        threads = [threading.Thread(target=thread_cb, args=(n,)) for n in range(nthreads)]
+        [t.start() for t in threads]
+        loop.run()
+        [t.join() for t in threads]
+        self.assertEqual(len(self.received), count * nthreads)
+        # items sent from the same thread are delivered in order
+        for n in range(nthreads):
+            self.assertEqual([i for (t, i) in self.received if t == n], list(range(count)))
+
+    def test_channel_closed(self):
+        loop = pyuv.Loop.default_loop()
+        channel = pyuv.Channel(loop, lambda *args: None)
+        channel.send(1)
+        channel.close()
+        self.assertEqual(channel.pending, 0)
+        self.assertRaises(pyuv.error.HandleClosedError, channel.send, 2)
+        loop.run()
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
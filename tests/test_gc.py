@@ -26,6 +26,18 @@ class GCTest(unittest2.TestCase):
         gc.collect()
         self.assertEqual(w_timer(), None)
 
+    def test_dealloc_open_handles(self):
+        # handles are closed when their object goes away, the loop must not touch the memory afterwards
+        loop = pyuv.Loop()
+        handles = [pyuv.Timer(loop), pyuv.Idle(loop), pyuv.Check(loop), pyuv.Prepare(loop), pyuv.TCP(loop), pyuv.UDP(loop), pyuv.Pipe(loop)]
+        handles[0].start(lambda x: None, 10, 10)
+        handles[1].start(lambda x: None)
+        w_handles = [weakref.ref(h) for h in handles]
+        handles = None
+        gc.collect()
+        self.assertEqual([w() for w in w_handles], [None] * len(w_handles))
+        self.assertFalse(loop.run())
+
 
 if __name__ == '__main__':
     unittest2.main(verbosity=2)
@@ -0,0 +1,53 @@
+
+from common import unittest2
+import pyuv
+
+
+class HooksTest(unittest2.TestCase):
+
+    def test_hooks_priority(self):
+        self.calls = []
+        def make_hook(name):
+            def hook(loop):
+                self.calls.append(name)
+            return hook
+        def timer_cb(timer):
+            timer.close()
+        loop = pyuv.Loop()
+        loop.add_check_hook(make_hook('check-10'), 10)
+        loop.add_check_hook(make_hook('check-0'))
+        loop.add_check_hook(make_hook('check-0b'))
+        loop.add_prepare_hook(make_hook('prepare-5'), priority=5)
+        loop.add_prepare_hook(make_hook('prepare--5'), priority=-5)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.001, 0)
+        loop.run(pyuv.UV_RUN_ONCE)
+        self.assertEqual(self.calls[:5], ['prepare--5', 'prepare-5', 'check-0', 'check-0b', 'check-10'])
+
+    def test_hooks_remove(self):
+        self.count = 0
+        def idle_hook(loop):
+            self.count += 1
+            if self.count == 10:
+                loop.remove_idle_hook(idle_hook)
+                async_handle.close()
+        loop = pyuv.Loop()
+        # idle hooks don't keep the loop alive
+        async_handle = pyuv.Async(loop, lambda x: None)
+        loop.add_idle_hook(idle_hook)
+        loop.run()
+        self.assertEqual(self.count, 10)
+        self.assertRaises(ValueError, loop.remove_idle_hook, idle_hook)
+        self.assertRaises(TypeError, loop.add_check_hook, 42)
+
+    def test_hooks_dont_keep_loop_alive(self):
+        def hook(loop):
+            pass
+        loop = pyuv.Loop()
+        loop.add_prepare_hook(hook)
+        loop.add_check_hook(hook)
+        self.assertFalse(loop.run())
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
@@ -1,4 +1,5 @@
 
+import socket
 import sys
 
 from common import unittest2, platform_skip
@@ -115,6 +116,78 @@ class IPCSendRecvTest(unittest2.TestCase):
         self.channel.start_read2(self.on_channel_read)
         self.loop.run()
 
+@platform_skip(["win32"])
+class IPCAutoAcceptTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+
+    def proc_exit_cb(self, proc, exit_status, term_signal):
+        proc.close()
+
+    def on_channel_read(self, handle, data, pending, error):
+        self.assertTrue(isinstance(pending, pyuv.Pipe))
+        self.recv_pipe = pending
+        self.channel.close()
+        self.send_pipe.close()
+        self.recv_pipe.close()
+
+    def test_ipc_auto_accept(self):
+        self.recv_pipe = None
+        self.send_pipe = pyuv.Pipe(self.loop, True)
+        self.send_pipe.bind(TEST_PIPE)
+        self.channel = pyuv.Pipe(self.loop, True)
+        stdio = [pyuv.StdIO(stream=self.channel, flags=pyuv.UV_CREATE_PIPE|pyuv.UV_READABLE_PIPE|pyuv.UV_WRITABLE_PIPE)]
+        proc = pyuv.Process(self.loop)
+        proc.spawn(file=sys.executable, args=["proc_ipc_echo.py"], exit_callback=self.proc_exit_cb, stdio=stdio)
+        self.channel.write2(b".", self.send_pipe)
+        self.channel.start_read2(self.on_channel_read, True)
+        self.loop.run()
+        self.assertNotEqual(self.recv_pipe, None)
+
+
+@platform_skip(["win32"])
+class IPCHandlesBatchTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+
+    def on_handles_written(self, handle, error):
+        self.assertEqual(error, None)
+        self.handles_written = True
+        for h in self.send_handles:
+            h.close()
+        self.sender.close()
+
+    def on_handles_read(self, handle, handles, error):
+        for h in handles:
+            self.assertTrue(isinstance(h, pyuv.TCP))
+            self.received.append(h)
+            h.close()
+        if error is not None or len(self.received) == len(self.send_handles):
+            self.receiver.close()
+
+    def test_ipc_handles_batch(self):
+        self.handles_written = False
+        self.received = []
+        sock1, sock2 = socket.socketpair()
+        self.sender = pyuv.Pipe(self.loop, True)
+        self.sender.open(sock1.fileno())
+        self.receiver = pyuv.Pipe(self.loop, True)
+        self.receiver.open(sock2.fileno())
+        self.send_handles = []
+        for i in range(4):
+            tcp = pyuv.TCP(self.loop)
+            tcp.bind(("127.0.0.1", TEST_PORT + i))
+            self.send_handles.append(tcp)
+        self.receiver.start_read_handles(self.on_handles_read)
+        self.sender.write_handles(self.send_handles, self.on_handles_written)
+        self.loop.run()
+        self.assertTrue(self.handles_written)
+        self.assertEqual(len(self.received), 4)
+        sock1.close()
+        sock2.close()
+
 
 if __name__ == '__main__':
     unittest2.main(verbosity=2)
@@ -0,0 +1,119 @@
+
+import select
+import threading
+import time
+
+from common import unittest2, platform_skip
+import pyuv
+
+
+class LoopRunTest(unittest2.TestCase):
+
+    def test_run_nowait(self):
+        self.cb_called = 0
+        def timer_cb(timer):
+            self.cb_called += 1
+        loop = pyuv.Loop.default_loop()
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 10, 0)
+        t0 = time.time()
+        self.assertTrue(loop.run(pyuv.UV_RUN_NOWAIT))
+        self.assertTrue(time.time() - t0 < 1)
+        self.assertEqual(self.cb_called, 0)
+        timer.close()
+        loop.run()
+
+    def test_run_timeout(self):
+        self.cb_called = 0
+        def timer_cb(timer):
+            self.cb_called += 1
+        loop = pyuv.Loop.default_loop()
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.01, 0.01)
+        self.assertTrue(loop.run(timeout=0.1))
+        self.assertTrue(self.cb_called > 1)
+        timer.close()
+        self.assertFalse(loop.run())
+
+    def test_run_once_timeout(self):
+        loop = pyuv.Loop.default_loop()
+        timer = pyuv.Timer(loop)
+        timer.start(lambda x: None, 10, 0)
+        t0 = time.time()
+        self.assertTrue(loop.run(pyuv.UV_RUN_ONCE, 0.05))
+        self.assertTrue(time.time() - t0 < 1)
+        timer.close()
+        loop.run()
+
+    def test_stop(self):
+        self.cb_called = 0
+        def timer_cb(timer):
+            self.cb_called += 1
+            loop.stop()
+        loop = pyuv.Loop.default_loop()
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.01, 0.01)
+        self.assertTrue(loop.run())
+        self.assertEqual(self.cb_called, 1)
+        timer.close()
+        loop.run()
+
+    def test_run_hold_gil(self):
+        self.cb_called = 0
+        self.thread_counter = 0
+        self.done = False
+        def thread_func():
+            while not self.done:
+                self.thread_counter += 1
+                time.sleep(0.001)
+        def async_cb(handle):
+            self.cb_called += 1
+            if self.cb_called == 10:
+                handle.close()
+                timer.close()
+            else:
+                handle.send()
+        def timer_cb(timer):
+            async_handle.send()
+        loop = pyuv.Loop()
+        async_handle = pyuv.Async(loop, async_cb)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.1, 0)
+        thread = threading.Thread(target=thread_func)
+        thread.start()
+        self.assertFalse(loop.run(hold_gil=True))
+        self.done = True
+        thread.join()
+        self.assertEqual(self.cb_called, 10)
+        # the GIL is released while polling, so the thread could run while the loop was waiting for the timer
+        self.assertTrue(self.thread_counter > 1)
+
+    @platform_skip(["win32"])
+    def test_embed(self):
+        self.cb_called = 0
+        def timer_cb(timer):
+            self.cb_called += 1
+            timer.close()
+        loop = pyuv.Loop()
+        self.assertEqual(loop.backend_timeout, 0)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.1, 0)
+        fd = loop.backend_fd
+        self.assertTrue(fd >= 0)
+        timeout = loop.backend_timeout
+        self.assertTrue(0 < timeout <= 0.1)
+        # drive the loop from a host loop, polling the backend fd
+        t0 = time.time()
+        while self.cb_called == 0 and time.time() - t0 < 5:
+            select.select([fd], [], [], loop.backend_timeout)
+            self.assertTrue(loop.process_events() or self.cb_called == 1)
+        self.assertEqual(self.cb_called, 1)
+        self.assertFalse(loop.process_events())
+        async_handle = pyuv.Async(loop, lambda handle: None)
+        self.assertEqual(loop.backend_timeout, None)
+        async_handle.close()
+        loop.run()
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
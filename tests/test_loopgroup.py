@@ -0,0 +1,82 @@
+
+import threading
+
+from common import unittest2
+import pyuv
+
+
+class LoopGroupTest(unittest2.TestCase):
+
+    def test_loopgroup_submit(self):
+        lock = threading.Lock()
+        done = threading.Event()
+        self.results = []
+        def cb(n):
+            with lock:
+                self.results.append((n, pyuv.Loop.current()))
+                if len(self.results) == 8:
+                    done.set()
+        group = pyuv.LoopGroup(4)
+        self.assertEqual(len(group.loops), 4)
+        group.start()
+        self.assertTrue(group.running)
+        loops = [group.submit(cb, n) for n in range(8)]
+        done.wait(5)
+        group.stop()
+        self.assertFalse(group.running)
+        self.assertEqual(sorted(n for n, loop in self.results), list(range(8)))
+        # calls run in the loop they were submitted to
+        for n, loop in self.results:
+            self.assertTrue(loop is loops[n])
+        self.assertEqual(loops, list(group.loops) * 2)
+
+    def test_loopgroup_restart(self):
+        done = threading.Event()
+        group = pyuv.LoopGroup(2)
+        group.start()
+        group.stop()
+        group.start()
+        group.loops[1].call_soon_threadsafe(done.set)
+        done.wait(5)
+        group.stop()
+        self.assertTrue(done.is_set())
+
+    def test_loopgroup_invalid(self):
+        self.assertRaises(ValueError, pyuv.LoopGroup, 0)
+        group = pyuv.LoopGroup.__new__(pyuv.LoopGroup)
+        self.assertRaises(RuntimeError, group.submit, lambda: None)
+
+
+class LoopCurrentTest(unittest2.TestCase):
+
+    def test_current(self):
+        self.current = None
+        def cb():
+            self.current = pyuv.Loop.current()
+        loop = pyuv.Loop()
+        loop.call_soon(cb)
+        loop.run()
+        self.assertTrue(self.current is loop)
+        self.assertTrue(pyuv.Loop.current() is pyuv.Loop.default_loop())
+
+    def test_call_soon_threadsafe(self):
+        self.calls = []
+        def cb(n):
+            self.calls.append(n)
+            if len(self.calls) == 100:
+                async_handle.close()
+        def thread_cb():
+            for n in range(100):
+                loop.call_soon_threadsafe(cb, n)
+        loop = pyuv.Loop()
+        # keep the loop alive until all calls were made
+        async_handle = pyuv.Async(loop, lambda x: None)
+        t = threading.Thread(target=thread_cb)
+        t.start()
+        loop.run()
+        t.join()
+        self.assertEqual(self.calls, list(range(100)))
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
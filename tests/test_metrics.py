@@ -0,0 +1,181 @@
+
+import time
+
+from common import unittest2
+import pyuv
+
+
+class LoopMetricsTest(unittest2.TestCase):
+
+    def test_metrics_disabled(self):
+        loop = pyuv.Loop()
+        self.assertRaises(RuntimeError, loop.get_metrics)
+
+    def test_metrics(self):
+        self.cb_called = 0
+        def timer_cb(timer):
+            self.cb_called += 1
+            if self.cb_called == 3:
+                timer.close()
+        loop = pyuv.Loop()
+        loop.enable_metrics(True)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.01, 0.01)
+        loop.run()
+        self.assertEqual(self.cb_called, 3)
+        metrics = loop.get_metrics()
+        self.assertTrue(metrics['iterations'] >= 3)
+        self.assertTrue(metrics['poll_time'] > 0)
+        count, t = metrics['callbacks']['timer']
+        self.assertEqual(count, 3)
+        self.assertTrue(t <= metrics['callback_time'])
+        self.assertEqual(metrics['callbacks']['fs'], (0, 0.0))
+        loop.reset_metrics()
+        metrics = loop.get_metrics()
+        self.assertEqual(metrics['iterations'], 0)
+        self.assertEqual(metrics['callbacks']['timer'], (0, 0.0))
+
+    def test_metrics_enable_disable(self):
+        loop = pyuv.Loop()
+        loop.enable_metrics(True)
+        loop.enable_metrics(False)
+        timer = pyuv.Timer(loop)
+        timer.start(lambda x: None, 0.001, 0)
+        loop.run()
+        self.assertEqual(loop.get_metrics()['callbacks']['timer'][0], 0)
+
+    def test_histograms(self):
+        self.cb_called = 0
+        def timer_cb(timer):
+            self.cb_called += 1
+            if self.cb_called == 10:
+                timer.close()
+        loop = pyuv.Loop()
+        self.assertRaises(RuntimeError, loop.get_histograms)
+        loop.enable_metrics(True, histograms=True)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.001, 0.001)
+        loop.run()
+        duration, delay = loop.get_histograms()['timer']
+        self.assertEqual(duration.count, 10)
+        self.assertEqual(delay.count, 10)
+        self.assertTrue(duration.min <= duration.percentile(50) <= duration.percentile(99) <= duration.max)
+        self.assertEqual(loop.get_histograms()['fs'][0].count, 0)
+        loop.reset_metrics()
+        self.assertEqual(loop.get_histograms()['timer'][0].count, 0)
+
+
+class SlowCallbackTest(unittest2.TestCase):
+
+    def test_slow_callback(self):
+        self.slow = []
+        def slow_function():
+            time.sleep(0.1)
+        def timer_cb(timer):
+            slow_function()
+            timer.close()
+        def fast_timer_cb(timer):
+            timer.close()
+        def handler(handle, callback, duration, stack):
+            self.slow.append((handle, callback, duration, stack))
+        loop = pyuv.Loop()
+        loop.set_slow_callback_threshold(0.05, handler)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.001, 0)
+        timer2 = pyuv.Timer(loop)
+        timer2.start(fast_timer_cb, 0.2, 0)
+        loop.run()
+        loop.set_slow_callback_threshold(0)
+        self.assertEqual(len(self.slow), 1)
+        handle, callback, duration, stack = self.slow[0]
+        self.assertTrue(handle is timer)
+        self.assertEqual(callback, timer_cb)
+        self.assertTrue(duration >= 0.1)
+        self.assertTrue(stack is not None)
+        self.assertTrue('slow_function' in [item[2] for item in stack])
+
+    def test_slow_callback_lower_threshold(self):
+        self.slow = []
+        def slow_function():
+            time.sleep(0.1)
+        def timer_cb(timer):
+            slow_function()
+            timer.close()
+        def handler(handle, callback, duration, stack):
+            self.slow.append(stack)
+        loop = pyuv.Loop()
+        loop.set_slow_callback_threshold(10, handler)
+        # the watchdog must start checking at the new rate, not every 5 seconds
+        loop.set_slow_callback_threshold(0.02, handler)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.05, 0)
+        loop.run()
+        loop.set_slow_callback_threshold(0)
+        self.assertEqual(len(self.slow), 1)
+        self.assertTrue(self.slow[0] is not None)
+        self.assertTrue('slow_function' in [item[2] for item in self.slow[0]])
+
+    def test_slow_callback_exception(self):
+        self.handler_called = 0
+        self.errors = []
+        def timer_cb(timer):
+            timer.close()
+            time.sleep(0.02)
+            raise ValueError('error')
+        def handler(handle, callback, duration, stack):
+            self.handler_called += 1
+        def excepthook(typ, value, tb):
+            self.errors.append(typ)
+        loop = pyuv.Loop()
+        loop.excepthook = excepthook
+        loop.set_slow_callback_threshold(0.01, handler)
+        timer = pyuv.Timer(loop)
+        timer.start(timer_cb, 0.001, 0)
+        loop.run()
+        self.assertEqual(self.handler_called, 1)
+        self.assertEqual(self.errors, [ValueError])
+
+    def test_slow_callback_invalid(self):
+        loop = pyuv.Loop()
+        self.assertRaises(TypeError, loop.set_slow_callback_threshold, 0.1, None)
+        self.assertRaises(ValueError, loop.set_slow_callback_threshold, -1, lambda *args: None)
+        self.assertRaises(ValueError, loop.set_slow_callback_threshold, float("nan"), lambda *args: None)
+        self.assertRaises(OverflowError, loop.set_slow_callback_threshold, 1e20, lambda *args: None)
+
+
+class HistogramTest(unittest2.TestCase):
+
+    def test_histogram(self):
+        h = pyuv.Histogram()
+        self.assertEqual(h.count, 0)
+        self.assertEqual(h.percentile(99), 0)
+        for i in range(1, 101):
+            h.record(i / 1000.0)
+        self.assertEqual(h.count, 100)
+        self.assertAlmostEqual(h.min, 0.001, places=6)
+        self.assertAlmostEqual(h.max, 0.1, places=6)
+        self.assertAlmostEqual(h.mean, 0.0505, places=4)
+        # buckets have a relative error of about 6%
+        self.assertTrue(abs(h.percentile(50) - 0.05) / 0.05 < 0.07)
+        self.assertTrue(abs(h.percentile(99) - 0.099) / 0.099 < 0.07)
+        self.assertAlmostEqual(h.percentile(100), 0.1, places=6)
+        self.assertRaises(ValueError, h.percentile, 101)
+        self.assertRaises(ValueError, h.record, -1)
+
+    def test_merge(self):
+        h1 = pyuv.Histogram()
+        h2 = pyuv.Histogram()
+        h1.record(0.001)
+        h2.record(1.0)
+        h3 = h1.copy()
+        h3.merge(h2)
+        self.assertEqual(h1.count, 1)
+        self.assertEqual(h3.count, 2)
+        self.assertAlmostEqual(h3.min, 0.001, places=6)
+        self.assertAlmostEqual(h3.max, 1.0, places=6)
+        h3.reset()
+        self.assertEqual(h3.count, 0)
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
@@ -0,0 +1,75 @@
+
+import mmap
+import os
+import struct
+
+from common import unittest2, platform_skip
+import pyuv
+
+
+@platform_skip(["win32", "cygwin", "darwin"])
+class ShmChannelTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+
+    def on_messages(self, channel, messages, error):
+        self.assertEqual(error, None)
+        self.received.extend(messages)
+        if len(self.received) == 100:
+            self.consumer.close()
+            self.producer.close()
+
+    def test_shmchannel_send_recv(self):
+        self.received = []
+        self.producer = pyuv.ShmChannel(self.loop, 4096)
+        shm_fd, event_fd = self.producer.fds
+        self.consumer = pyuv.ShmChannel(self.loop, fds=(os.dup(shm_fd), os.dup(event_fd)))
+        self.consumer.start(self.on_messages)
+        for i in range(100):
+            self.producer.send(("message %d" % i).encode())
+        self.assertTrue(self.producer.pending > 0)
+        self.loop.run()
+        self.assertEqual(self.received, [("message %d" % i).encode() for i in range(100)])
+
+    def test_shmchannel_full(self):
+        channel = pyuv.ShmChannel(self.loop, 4096)
+        data = b"x" * 1000
+        self.assertRaises(pyuv.error.ShmChannelError, lambda: [channel.send(data) for i in range(10)])
+        self.assertRaises(ValueError, channel.send, b"x" * 8192)
+        channel.close()
+        self.loop.run()
+
+    def on_corrupted_messages(self, channel, messages, error):
+        self.assertEqual(error, None)
+        self.received.extend(messages)
+
+    def test_shmchannel_corrupted(self):
+        self.received = []
+        self.errors = []
+        def excepthook(typ, value, tb):
+            self.errors.append(typ)
+        loop = pyuv.Loop()
+        loop.excepthook = excepthook
+        producer = pyuv.ShmChannel(loop, 4096)
+        shm_fd, event_fd = producer.fds
+        consumer = pyuv.ShmChannel(loop, fds=(os.dup(shm_fd), os.dup(event_fd)))
+        producer.send(b"a")
+        producer.send(b"b")
+        # the ring follows the header page, give the second message a bogus length
+        segment = mmap.mmap(shm_fd, 0)
+        segment[mmap.PAGESIZE + 5:mmap.PAGESIZE + 9] = struct.pack("=I", 1000)
+        segment.close()
+        consumer.start(self.on_corrupted_messages)
+        loop.run_once()
+        self.assertEqual(self.received, [b"a"])
+        self.assertEqual(self.errors, [pyuv.error.ShmChannelError])
+        self.assertRaises(pyuv.error.ShmChannelError, producer.send, b"c")
+        self.assertRaises(pyuv.error.ShmChannelError, consumer.start, self.on_corrupted_messages)
+        consumer.close()
+        producer.close()
+        loop.run()
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
@@ -1,6 +1,7 @@
 
 import os
 import signal
+import socket
 import time
 import threading
 
@@ -65,6 +66,43 @@ class MultiLoopSignalTest(unittest2.TestCase):
         self.assertEqual(self.signal_cb_called, 25)
 
 
+@platform_skip(["win32"])
+class SignalCheckerTest(unittest2.TestCase):
+
+    def signal_handler(self, signum, frame):
+        self.signal_handler_called += 1
+        self.timer.close()
+        self.checker.close()
+
+    def timer_cb(self, timer):
+        if not self.signal_sent:
+            self.signal_sent = True
+            os.kill(os.getpid(), signal.SIGUSR2)
+
+    def test_signal_checker_wakeup_fd(self):
+        self.signal_handler_called = 0
+        self.signal_sent = False
+        rsock, wsock = socket.socketpair()
+        rsock.setblocking(False)
+        wsock.setblocking(False)
+        old_handler = signal.signal(signal.SIGUSR2, self.signal_handler)
+        old_fd = signal.set_wakeup_fd(wsock.fileno())
+        try:
+            self.loop = pyuv.Loop.default_loop()
+            self.checker = pyuv.SignalChecker(self.loop, rsock.fileno())
+            self.checker.start()
+            self.timer = pyuv.Timer(self.loop)
+            self.timer.start(self.timer_cb, 0.01, 0.01)
+            self.loop.run()
+        finally:
+            signal.set_wakeup_fd(old_fd)
+            signal.signal(signal.SIGUSR2, old_handler)
+            rsock.close()
+            wsock.close()
+        self.assertEqual(self.signal_handler_called, 1)
+        self.assertTrue(self.checker.closed)
+
+
 if __name__ == '__main__':
     unittest2.main(verbosity=2)
 
@@ -2,7 +2,7 @@
 import socket
 import sys
 
-from common import unittest2
+from common import unittest2, platform_skip
 import common
 import pyuv
 
@@ -449,6 +449,205 @@ class TCPFlagsTest(unittest2.TestCase):
         self.assertTrue(True)
 
 
+class TCPTimeoutTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+        self.server = None
+        self.client = None
+        self.timeout_events = []
+
+    def on_connection(self, server, error):
+        self.assertEqual(error, None)
+        client = pyuv.TCP(pyuv.Loop.default_loop())
+        server.accept(client)
+        client.start_read(self.on_client_connection_read)
+        client.set_timeout(self.on_client_connection_timeout, 0.2)
+
+    def on_client_connection_read(self, client, data, error):
+        if data is None:
+            client.close()
+
+    def on_client_connection_timeout(self, client, events):
+        self.timeout_events.append(events)
+        client.close()
+        self.server.close()
+        self.client.close()
+
+    def on_client_connection(self, client, error):
+        self.assertEqual(error, None)
+
+    def test_tcp_timeout(self):
+        self.server = pyuv.TCP(self.loop)
+        self.server.bind(("0.0.0.0", TEST_PORT))
+        self.server.listen(self.on_connection)
+        self.client = pyuv.TCP(self.loop)
+        self.client.connect(("127.0.0.1", TEST_PORT), self.on_client_connection)
+        self.loop.run()
+        self.assertEqual(self.timeout_events, [pyuv.UV_READABLE])
+
+    def on_write_idle_connection(self, server, error):
+        self.assertEqual(error, None)
+        client = pyuv.TCP(pyuv.Loop.default_loop())
+        server.accept(client)
+        client.start_read(self.on_client_connection_read)
+        client.set_timeout(callback=self.on_client_connection_timeout, write_idle=0.2)
+
+    def test_tcp_write_timeout(self):
+        self.server = pyuv.TCP(self.loop)
+        self.server.bind(("0.0.0.0", TEST_PORT))
+        self.server.listen(self.on_write_idle_connection)
+        self.client = pyuv.TCP(self.loop)
+        self.client.connect(("127.0.0.1", TEST_PORT), self.on_client_connection)
+        self.assertRaises(ValueError, self.client.set_timeout, self.on_client_connection_timeout, read_idle=float("nan"))
+        self.assertRaises(OverflowError, self.client.set_timeout, self.on_client_connection_timeout, write_idle=1e20)
+        self.loop.run()
+        self.assertEqual(self.timeout_events, [pyuv.UV_WRITABLE])
+
+
+class TCPTimeoutRearmTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+        self.timeouts = []
+
+    def on_connection(self, server, error):
+        self.assertEqual(error, None)
+        self.conn = pyuv.TCP(self.loop)
+        server.accept(self.conn)
+        self.conn.start_read(self.on_conn_read)
+        # both streams expire in the same tick
+        self.conn.set_timeout(self.on_timeout, 0.2)
+        self.client.set_timeout(self.on_timeout, 0.2)
+
+    def on_conn_read(self, conn, data, error):
+        pass
+
+    def on_timeout(self, handle, events):
+        self.timeouts.append(handle)
+        if len(self.timeouts) == 1:
+            # re-arm the other stream, which already expired but wasn't dispatched yet
+            other = self.client if handle is self.conn else self.conn
+            other.set_timeout(self.on_timeout, 0.3)
+            handle.set_timeout(None)
+        else:
+            self.close_all()
+
+    def on_guard_timer(self, timer):
+        self.close_all()
+
+    def close_all(self):
+        self.guard.close()
+        self.conn.close()
+        self.client.close()
+        self.server.close()
+
+    def on_client_connection(self, client, error):
+        self.assertEqual(error, None)
+
+    def test_tcp_timeout_rearm(self):
+        self.server = pyuv.TCP(self.loop)
+        self.server.bind(("0.0.0.0", TEST_PORT))
+        self.server.listen(self.on_connection)
+        self.client = pyuv.TCP(self.loop)
+        self.client.connect(("127.0.0.1", TEST_PORT), self.on_client_connection)
+        self.guard = pyuv.Timer(self.loop)
+        self.guard.start(self.on_guard_timer, 5.0, 0)
+        self.loop.run()
+        self.assertEqual(len(self.timeouts), 2)
+        self.assertTrue(self.timeouts[0] is not self.timeouts[1])
+
+
+class TCPConnectAnyTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+        self.server = None
+        self.client_connections = []
+
+    def on_connection(self, server, error):
+        self.assertEqual(error, None)
+        client = pyuv.TCP(pyuv.Loop.default_loop())
+        server.accept(client)
+        self.client_connections.append(client)
+        client.start_read(self.on_client_connection_read)
+
+    def on_client_connection_read(self, client, data, error):
+        if data is None:
+            client.close()
+            self.client_connections.remove(client)
+            self.server.close()
+            return
+
+    def on_client_connection(self, client, error):
+        self.assertEqual(error, None)
+        # only the IPv6 listener exists, so the IPv4 attempt must have lost
+        self.assertEqual(client.getpeername(), ("::1", TEST_PORT))
+        client.close()
+
+    @unittest2.skipUnless(socket.has_ipv6, "IPv6 is not available")
+    def test_connect_any(self):
+        self.server = pyuv.TCP(self.loop)
+        self.server.bind(("::1", TEST_PORT))
+        self.server.listen(self.on_connection)
+        client = pyuv.TCP(self.loop)
+        client.connect_any([("127.0.0.1", TEST_PORT), ("::1", TEST_PORT)], self.on_client_connection, 0.05)
+        self.loop.run()
+
+    def on_client_connection_error(self, client, error):
+        self.assertNotEqual(error, None)
+        client.close()
+
+    def test_connect_any_error(self):
+        client = pyuv.TCP(self.loop)
+        self.assertRaises(ValueError, client.connect_any, [], self.on_client_connection_error)
+        client.connect_any([("127.0.0.1", TEST_PORT), ("127.0.0.1", TEST_PORT+1)], self.on_client_connection_error)
+        self.loop.run()
+
+
+@platform_skip(["win32", "cygwin", "darwin"])
+class TCPInfoTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+        self.server = None
+        self.client = None
+        self.client_connections = []
+
+    def on_connection(self, server, error):
+        self.assertEqual(error, None)
+        client = pyuv.TCP(pyuv.Loop.default_loop())
+        server.accept(client)
+        self.client_connections.append(client)
+        client.start_read(self.on_client_connection_read)
+
+    def on_client_connection_read(self, client, data, error):
+        if data is None:
+            client.close()
+            self.client_connections.remove(client)
+            self.server.close()
+            return
+
+    def on_client_connection(self, client, error):
+        self.assertEqual(error, None)
+        info = client.get_info()
+        self.assertTrue(info.rtt >= 0)
+        self.assertTrue(info.snd_cwnd > 0)
+        self.assertTrue(info.snd_mss > 0)
+        self.assertEqual(info.total_retrans, 0)
+        handles = [handle for handle, info in self.loop.get_tcp_info()]
+        self.assertTrue(client in handles)
+        client.close()
+
+    def test_tcp_info(self):
+        self.server = pyuv.TCP(self.loop)
+        self.server.bind(("0.0.0.0", TEST_PORT))
+        self.server.listen(self.on_connection)
+        self.client = pyuv.TCP(self.loop)
+        self.client.connect(("127.0.0.1", TEST_PORT), self.on_client_connection)
+        self.loop.run()
+
+
 if __name__ == '__main__':
     unittest2.main(verbosity=2)
 
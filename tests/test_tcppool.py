@@ -0,0 +1,112 @@
+
+from common import unittest2
+import pyuv
+
+
+TEST_PORT = 1234
+
+class TCPPoolTest(unittest2.TestCase):
+
+    def setUp(self):
+        self.loop = pyuv.Loop.default_loop()
+        self.server = pyuv.TCP(self.loop)
+        self.server.bind(("0.0.0.0", TEST_PORT))
+        self.server.listen(self.on_connection)
+        self.pool = pyuv.TCPPool(self.loop, max_per_host=1, idle_timeout=0.5)
+        self.connections = []
+        self.handles = []
+
+    def on_connection(self, server, error):
+        self.assertEqual(error, None)
+        client = pyuv.TCP(self.loop)
+        server.accept(client)
+        self.connections.append(client)
+
+    def on_acquire(self, pool, handle, error):
+        self.assertEqual(error, None)
+        self.handles.append(handle)
+        if len(self.handles) == 1:
+            # max_per_host is 1, this one waits until the first handle is released
+            pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire)
+            pool.release(handle)
+        else:
+            pool.release(handle)
+            self.assertEqual(pool.idle, 1)
+            self.server.close()
+            [c.close() for c in self.connections]
+
+    def test_tcppool_reuse(self):
+        self.pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire)
+        self.loop.run()
+        self.assertEqual(len(self.handles), 2)
+        self.assertTrue(self.handles[0] is self.handles[1])
+        self.assertEqual(len(self.connections), 1)
+        self.assertEqual(self.pool.idle, 0)
+        self.pool.close()
+        self.assertTrue(self.pool.closed)
+
+    def on_acquire_close(self, pool, handle, error):
+        self.assertEqual(error, None)
+        pool.release(handle)
+        self.assertEqual(pool.idle, 1)
+        self.server.close()
+        pool.close()
+        self.assertEqual(pool.idle, 0)
+        [c.close() for c in self.connections]
+
+    def test_tcppool_close(self):
+        self.pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire_close)
+        self.loop.run()
+        self.assertRaises(pyuv.error.TCPPoolError, self.pool.acquire, ("127.0.0.1", TEST_PORT), self.on_acquire_close)
+
+    def on_acquire_unreleased(self, pool, handle, error):
+        self.assertEqual(error, None)
+        self.handles.append(handle)
+        if len(self.handles) == 1:
+            # closed without being released, the next request gets its slot back
+            handle.close()
+            pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire_unreleased)
+        else:
+            pool.release(handle)
+            self.server.close()
+            [c.close() for c in self.connections]
+
+    def test_tcppool_closed_without_release(self):
+        self.pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire_unreleased)
+        self.loop.run()
+        self.assertEqual(len(self.handles), 2)
+        self.assertFalse(self.handles[0] is self.handles[1])
+        self.pool.close()
+
+
+class TCPPoolErrorTest(unittest2.TestCase):
+
+    def on_acquire_error(self, pool, handle, error):
+        self.assertEqual(handle, None)
+        self.assertNotEqual(error, None)
+        self.errors += 1
+
+    def test_tcppool_connect_error(self):
+        self.errors = 0
+        loop = pyuv.Loop.default_loop()
+        pool = pyuv.TCPPool(loop, 1)
+        pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire_error)
+        pool.acquire(("127.0.0.1", TEST_PORT), self.on_acquire_error)
+        loop.run()
+        self.assertEqual(self.errors, 2)
+        pool.close()
+
+    def test_tcppool_release_foreign(self):
+        loop = pyuv.Loop.default_loop()
+        pool = pyuv.TCPPool(loop)
+        tcp = pyuv.TCP(loop)
+        self.assertRaises(ValueError, pool.release, tcp)
+        self.assertRaises(ValueError, pyuv.TCPPool, loop, 0)
+        tcp.close()
+        pool.close()
+        loop.run()
+
+
+if __name__ == '__main__':
+    unittest2.main(verbosity=2)
+
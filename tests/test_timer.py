@@ -57,6 +57,108 @@ class TimerTest(unittest2.TestCase):
         loop.run()
         self.assertEqual(self.timer_cb_called, 1)
 
+    def test_timer_ns(self):
+        self.timer_cb_called = 0
+        def timer_cb(timer):
+            self.timer_cb_called += 1
+            if self.timer_cb_called == 2:
+                timer.close()
+        loop = pyuv.Loop.default_loop()
+        timer = pyuv.Timer(loop)
+        start = loop.now_ns()
+        self.assertEqual(start, loop.now() * 1000000)
+        timer.start_ns(timer_cb, 50000000, 10500000)
+        self.assertEqual(timer.repeat_ns, 11000000)
+        timer.repeat_ns = 20000000
+        self.assertEqual(timer.repeat, 0.02)
+        loop.run()
+        self.assertEqual(self.timer_cb_called, 2)
+        self.assertTrue(loop.now_ns() - start >= 70000000)
+
+    def test_timer_ns_invalid(self):
+        loop = pyuv.Loop.default_loop()
+        timer = pyuv.Timer(loop)
+        self.assertRaises(ValueError, timer.start_ns, lambda t: None, -1, 0)
+        self.assertRaises(ValueError, timer.start_ns, lambda t: None, 0, -1)
+        self.assertRaises(OverflowError, timer.start_ns, lambda t: None, 2**64, 0)
+        timer.close()
+        loop.run()
+
+    def test_timer_slack(self):
+        self.times = []
+        def timer_cb(timer):
+            self.times.append(loop.now())
+            timer.close()
+        loop = pyuv.Loop.default_loop()
+        timer1 = pyuv.Timer(loop)
+        timer1.slack = 1.0
+        timer2 = pyuv.Timer(loop)
+        timer2.slack = 1.0
+        self.assertEqual(timer2.slack, 1.0)
+        timer1.start(timer_cb, 0.001, 0)
+        timer2.start(timer_cb, 0.002, 0)
+        loop.run()
+        self.assertEqual(len(self.times), 2)
+        self.assertEqual(self.times[0], self.times[1])
+
+
+class TimerWheelTest(unittest2.TestCase):
+
+    def test_timerwheel1(self):
+        self.fired = []
+        def entry_cb(entry):
+            self.fired.append(entry)
+        loop = pyuv.Loop.default_loop()
+        wheel = pyuv.TimerWheel(loop, 0.01, 16)
+        entries = [wheel.schedule(entry_cb, 0.01 * (i % 50)) for i in range(200)]
+        self.assertEqual(wheel.pending, 200)
+        loop.run()
+        self.assertEqual(len(self.fired), 200)
+        self.assertEqual(wheel.pending, 0)
+        self.assertFalse(entries[0].active)
+        wheel.close()
+        loop.run()
+
+    def test_timerwheel_cancel(self):
+        self.fired = []
+        def entry_cb(entry):
+            self.fired.append(entry)
+        loop = pyuv.Loop.default_loop()
+        wheel = pyuv.TimerWheel(loop, 0.01)
+        entry1 = wheel.schedule(entry_cb, 0.1)
+        entry2 = wheel.schedule(entry_cb, 0.2)
+        self.assertTrue(entry2.active)
+        entry2.cancel()
+        entry2.cancel()
+        self.assertFalse(entry2.active)
+        loop.run()
+        self.assertEqual(self.fired, [entry1])
+        wheel.close()
+        loop.run()
+
+    def test_timerwheel_close(self):
+        self.fired = 0
+        def entry_cb(entry):
+            self.fired += 1
+            entry.wheel.close()
+        loop = pyuv.Loop.default_loop()
+        wheel = pyuv.TimerWheel(loop, 0.01)
+        for i in range(10):
+            wheel.schedule(entry_cb, 0.05)
+        loop.run()
+        self.assertEqual(self.fired, 1)
+        self.assertRaises(ValueError, pyuv.TimerWheel, loop, 0.01, 100)
+        self.assertRaises(ValueError, pyuv.TimerWheel, loop, 0.0001)
+        self.assertRaises(ValueError, pyuv.TimerWheel, loop, float("nan"))
+        self.assertRaises(OverflowError, pyuv.TimerWheel, loop, 1e20)
+        wheel = pyuv.TimerWheel(loop, 0.01)
+        self.assertRaises(ValueError, wheel.schedule, lambda entry: None, float("nan"))
+        self.assertRaises(OverflowError, wheel.schedule, lambda entry: None, float("inf"))
+        self.assertRaises(OverflowError, wheel.schedule, lambda entry: None, 1e20)
+        self.assertEqual(wheel.pending, 0)
+        wheel.close()
+        loop.run()
+
 
 if __name__ == '__main__':
     unittest2.main(verbosity=2)
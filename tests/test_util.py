@@ -57,6 +57,26 @@ class UtilTest(unittest2.TestCase):
         pyuv.util.getaddrinfo(loop, 'localhost', getaddrinfo_cb, 80, socket.AF_INET)
         loop.run()
 
+    def test_freelist(self):
+        self.assertEqual(pyuv.util.get_freelist_size(), 64)
+        loop = pyuv.Loop()
+        # reused objects must look brand new
+        for i in range(3):
+            timer = pyuv.Timer(loop)
+            self.assertFalse(timer.active)
+            self.assertFalse(timer.closed)
+            self.assertEqual(timer.repeat, 0)
+            self.assertFalse(hasattr(timer, 'foo'))
+            timer.start(lambda x: x.close(), 0.001, 0)
+            timer.foo = i
+            loop.run()
+            self.assertTrue(timer.closed)
+            timer = None
+        pyuv.util.set_freelist_size(0)
+        self.assertEqual(pyuv.util.get_freelist_size(), 0)
+        pyuv.util.set_freelist_size(64)
+        self.assertRaises(ValueError, pyuv.util.set_freelist_size, -1)
+
 
 if __name__ == '__main__':
     unittest2.main(verbosity=2)